@@ -22,6 +22,24 @@ FINAL_RELEASE {
 # cg3lib works with c++11
 CONFIG += c++11
 
+# DAG::locate answers batches of queries on multiple threads
+CONFIG += thread
+
+# The exact orientation test (Utils::orientation) needs every floating point
+# operation to be rounded on its own, without fused multiply-adds
+unix {
+    QMAKE_CXXFLAGS += -ffp-contract=off
+}
+
+# Uncomment next line to count the orientation tests solved by the fast path
+#DEFINES += ORIENTATION_STATISTICS
+
+# Uncomment next line to count the queries answered by the DAG and the nodes they visit
+#DEFINES += DAG_STATISTICS
+
+# Uncomment next line to store the indexes inside Trapezoids and DAGnodes on 64 bits instead of 32
+#DEFINES += TRAPEZOIDALMAP_64BIT_INDEXES
+
 # Cg3lib configuration. Available options:
 #
 #   CG3_ALL                 -- All the modules
@@ -41,18 +59,27 @@ DISTFILES += \
 
 SOURCES +=  \
     algorithms/algorithms.cpp \
+    algorithms/segment_intersections.cpp \
+    data_structures/compact_dag.cpp \
     data_structures/dag.cpp \
+    data_structures/dag_jump_table.cpp \
     data_structures/dagnode.cpp \
     data_structures/segment_intersection_checker.cpp \
     data_structures/trapezoid.cpp \
     data_structures/trapezoidalmap.cpp \
     data_structures/trapezoidalmap_dataset.cpp \
+    data_structures/trapezoidalmap_faces.cpp \
+    data_structures/trapezoidalmap_snapshot.cpp \
+    data_structures/walking_locator.cpp \
     drawables/drawable_trapezoidalmap_dataset.cpp \
     drawables/drawabletrapezoid.cpp \
     drawables/drawabletrapezoidalmap.cpp \
+    drawables/trapezoidvertexbuffer.cpp \
+    drawables/trapezoidvertexupdater.cpp \
     main.cpp \
     managers/trapezoidalmap_manager.cpp \
     utils/fileutils.cpp \
+    utils/mappedfile.cpp \
     utils/utils.cpp
 
 FORMS += \
@@ -60,17 +87,30 @@ FORMS += \
 
 HEADERS += \
     algorithms/algorithms.h \
+    algorithms/segment_intersections.h \
+    data_structures/compact_dag.h \
     data_structures/dag.h \
+    data_structures/dag_jump_table.h \
     data_structures/dagnode.h \
     data_structures/segment_intersection_checker.h \
+    data_structures/stored_index.h \
     data_structures/trapezoid.h \
     data_structures/trapezoidalmap.h \
     data_structures/trapezoidalmap_dataset.h \
+    data_structures/trapezoidalmap_faces.h \
+    data_structures/trapezoidalmap_observer.h \
+    data_structures/trapezoidalmap_snapshot.h \
+    data_structures/version_history.h \
+    data_structures/walking_locator.h \
     drawables/drawable_trapezoidalmap_dataset.h \
     drawables/drawabletrapezoid.h \
     drawables/drawabletrapezoidalmap.h \
+    drawables/trapezoidvertexbuffer.h \
+    drawables/trapezoidvertexupdater.h \
     managers/trapezoidalmap_manager.h \
+    utils/expansion.h \
     utils/fileutils.h \
+    utils/mappedfile.h \
     utils/utils.h
 
 
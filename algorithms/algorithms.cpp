@@ -1,19 +1,30 @@
 #include "algorithms.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+/* A removal leaves the unreachable DAGnodes of the replaced leaves and adds new ones, a DAG larger
+ * than this many times the number of live Trapezoids (about 3 for a fresh construction) is rebuilt.
+ * The map is rebuilt as well when more than half of its Segments have been released by the removals */
+#define REBUILD_DAG_SIZE_FACTOR 8
+
+/* Each removal leaves a free slot in the Trapezoidal Map, which is compacted
+ * when more than one slot out of this many is free */
+#define COMPACT_FREE_SLOT_FRACTION 4
+
 namespace Algorithms {
     /**
      * @brief finds all the Trapzeoids in which a Segment lies.
      * @param segment, the Segment
      * @param dag, the DAG
      * @param tm, the Trapezoidal Map
-     * @return a vector containing the indexes of the Trapezoids in which the segment lies (from left to right)
+     * @param trapezoids, it will contain the indexes of the Trapezoids in which the segment lies (from left to right),
+     * its previous content is discarded but its capacity is reused
      */
-    std::vector<size_t> followSegment(const cg3::Segment2d& segment, DAG& dag, TrapezoidalMap& tm) {
-        std::vector<size_t> trapezoids;
-
-        cg3::Point2d firstPoint = segment.p1();
-        cg3::Point2d secondPoint = segment.p2();
-        trapezoids.push_back(dag.findPoint(firstPoint, secondPoint));
+    void followSegment(const cg3::Segment2d& segment, const DAG& dag, const TrapezoidalMap& tm, std::vector<size_t>& trapezoids) {
+        trapezoids.clear();
+        trapezoids.push_back(dag.findPoint(segment.p1(), segment.p2()));
 
         /* As long as the Trapezoid we are analyzing does not contain
          * the right endpoint of the Segment
@@ -23,30 +34,338 @@ namespace Algorithms {
          *      if the rightmost point of the Trapezoid lies
          *      on the RIGHT of the Segment
          *          the TOP-right neighbor can be added to the Vector */
-        int j = 0;
-        while(segment.p2().x() > tm.getTrapezoid(trapezoids[j]).getRightP().x()) {
-            if(Utils::isPointOnTheLeft(segment ,tm.getTrapezoid(trapezoids[j]).getRightP()))
-                trapezoids.push_back(tm.getTrapezoid(trapezoids[j]).getBotRightNeighbor());
+        const Trapezoid* current = &tm.getTrapezoid(trapezoids.back());
+        while(segment.p2().x() > tm.getRightP(*current).x()) {
+            if(Utils::isPointOnTheLeft(segment, tm.getRightP(*current)))
+                trapezoids.push_back(current->getBotRightNeighbor());
             else
-                trapezoids.push_back(tm.getTrapezoid(trapezoids[j]).getTopRightNeighbor());
-            j++;
+                trapezoids.push_back(current->getTopRightNeighbor());
+            current = &tm.getTrapezoid(trapezoids.back());
         }
+    }
 
+    /**
+     * @brief finds all the Trapzeoids in which a Segment lies.
+     * @param segment, the Segment
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @return a vector containing the indexes of the Trapezoids in which the segment lies (from left to right)
+     */
+    std::vector<size_t> followSegment(const cg3::Segment2d& segment, const DAG& dag, const TrapezoidalMap& tm) {
+        std::vector<size_t> trapezoids;
+        followSegment(segment, dag, tm, trapezoids);
         return trapezoids;
     }
 
+    namespace {
+        /**
+         * @brief Computes the y coordinate of the line through a Segment at a given x
+         * @param segment, the Segment (from left to right, not vertical unless x is one of its endpoints)
+         * @param x, the x coordinate
+         * @return the y coordinate, exact on the endpoints
+         */
+        inline double yAt(const cg3::Segment2d& segment, const double& x) {
+            if(x == segment.p1().x())
+                return segment.p1().y();
+            if(x == segment.p2().x())
+                return segment.p2().y();
+            return segment.p1().y() + (x - segment.p1().x()) * (segment.p2().y() - segment.p1().y()) / (segment.p2().x() - segment.p1().x());
+        }
+
+        /**
+         * @brief Computes the orientation of a Point with respect to the line through a Segment
+         * @return a positive value if the Point is on the left of the Segment, a negative value if it is on the right,
+         * zero if it is on the line
+         */
+        inline double orientation(const cg3::Segment2d& segment, const cg3::Point2d& point) {
+            return Utils::orientation(segment.p1().x(), segment.p1().y(), segment.p2().x(), segment.p2().y(),
+                                      point.x(), point.y());
+        }
+
+        /**
+         * @brief Tells if a query Segment leaves a Trapezoid through its top (or bot) Segment,
+         * that is if at the right end of its part inside the Trapezoid it lies strictly above the top Segment
+         * (or below the bot one). The test is exact when that end is the right endpoint of the query
+         * or the right endpoint of the tested Segment.
+         * @param query, the query Segment (from left to right), entering the Trapezoid from its left
+         * @param tm, the Trapezoidal Map
+         * @param trapezoid, the Trapezoid
+         * @param top, true to test the top Segment, false for the bot one
+         * @return true if the query crosses the Segment inside the Trapezoid
+         */
+        bool leavesThrough(const cg3::Segment2d& query, const TrapezoidalMap& tm, const Trapezoid& trapezoid, const bool& top) {
+            size_t id = top ? trapezoid.getTopId() : trapezoid.getBotId();
+            const cg3::Segment2d& segment = tm.getSegment(id);
+            const cg3::Point2d& rightP = tm.getRightP(trapezoid);
+
+            /* Positive if the query is above the Segment */
+            double side;
+            if(query.p2().x() <= rightP.x())
+                side = orientation(segment, query.p2());
+            else if(trapezoid.getRightPId() == TrapezoidalMap::getRightPointId(id))
+                side = -orientation(query, rightP);
+            else
+                side = yAt(query, rightP.x()) - yAt(segment, rightP.x());
+
+            return top ? side > 0 : side < 0;
+        }
+
+        /**
+         * @brief Computes the Point of a Segment of the map where a query Segment crosses it inside a Trapezoid
+         * @param query, the query Segment (from left to right)
+         * @param segment, the crossed Segment (from left to right)
+         * @param minX, maxX, the part of the Trapezoid crossed by the query
+         * @return the crossing Point, lying on the Segment between minX and maxX
+         */
+        cg3::Point2d crossingPoint(const cg3::Segment2d& query, const cg3::Segment2d& segment, const double& minX, const double& maxX) {
+            double dx1 = query.p2().x() - query.p1().x(), dy1 = query.p2().y() - query.p1().y();
+            double dx2 = segment.p2().x() - segment.p1().x(), dy2 = segment.p2().y() - segment.p1().y();
+            double d = dx1 * dy2 - dy1 * dx2;
+
+            double x = maxX;
+            if(d != 0) {
+                double t = ((segment.p1().x() - query.p1().x()) * dy2 - (segment.p1().y() - query.p1().y()) * dx2) / d;
+                x = std::max(minX, std::min(maxX, query.p1().x() + t * dx1));
+            }
+
+            return cg3::Point2d(x, yAt(segment, x));
+        }
+
+        /**
+         * @brief Tells if the region between two Segments (from left to right) and two vertical lines touches a window
+         * @param bot, the lower Segment
+         * @param top, the upper Segment
+         * @param minX, maxX, the vertical lines, inside the x range of both Segments
+         * @param window, the window
+         * @return true if the region and the window have at least a point in common
+         */
+        bool touchesWindow(const cg3::Segment2d& bot, const cg3::Segment2d& top, const double& minX, const double& maxX,
+                           const cg3::BoundingBox2& window) {
+            double x1 = std::max(minX, window.min().x());
+            double x2 = std::min(maxX, window.max().x());
+            if(x1 > x2)
+                return false;
+
+            /* The Segments are straight: where the lower one is below the top of the window
+             * and the upper one is above its bottom, at some x between x1 and x2 they are both */
+            return std::min(yAt(bot, x1), yAt(bot, x2)) <= window.max().y() &&
+                   std::max(yAt(top, x1), yAt(top, x2)) >= window.min().y();
+        }
+
+        /**
+         * @brief Tells if a Segment (from left to right) touches a window
+         * @param segment, the Segment
+         * @param window, the window
+         * @return true if the Segment and the window have at least a point in common
+         */
+        bool touchesWindow(const cg3::Segment2d& segment, const cg3::BoundingBox2& window) {
+            if(segment.p1().x() == segment.p2().x()) {
+                return segment.p1().x() >= window.min().x() && segment.p1().x() <= window.max().x() &&
+                       segment.p1().y() <= window.max().y() && segment.p2().y() >= window.min().y();
+            }
+            return touchesWindow(segment, segment, segment.p1().x(), segment.p2().x(), window);
+        }
+    }
+
+    /**
+     * @brief Finds all the Trapezoids and all the Segments of the map crossed by a query Segment, without changing the map.
+     *
+     * Unlike followSegment, the query can cross the Segments of the map.
+     * The query is followed from left to right through the right neighbors of the Trapezoids,
+     * as in followSegment, until it leaves a Trapezoid through its top or bot Segment: the Trapezoid
+     * on the other side of that Segment is then found by the DAG, since the neighbors never cross a Segment.
+     * A query crossing c Segments of the map and k Trapezoids takes O((c+1) log n + k) expected time.
+     * The query has to lie inside the bounding box; touching a Segment of the map counts as crossing it
+     * only when the query goes to its other side.
+     * @param query, the query Segment, in any direction
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @param trace, it will contain the crossed Trapezoids and Segments (in the direction of the query),
+     * its previous content is discarded but its capacity is reused
+     */
+    void traceSegment(const cg3::Segment2d& query, const DAG& dag, const TrapezoidalMap& tm, SegmentTrace& trace) {
+        trace.trapezoids.clear();
+        trace.segments.clear();
+
+        cg3::Segment2d segment = Utils::fixSegmentDirection(query);
+        size_t current = dag.findPoint(segment.p1(), segment.p2());
+
+        /* Entering point of the query inside the current Trapezoid */
+        double entryX = segment.p1().x();
+
+        /* A line crosses another one only once: this avoids crossing back because of a rounding */
+        size_t lastCrossed = SIZE_MAX;
+
+        while(current != SIZE_MAX) {
+            trace.trapezoids.push_back(current);
+            const Trapezoid& trapezoid = tm.getTrapezoid(current);
+            const cg3::Point2d& rightP = tm.getRightP(trapezoid);
+
+            bool top = leavesThrough(segment, tm, trapezoid, true);
+            if(top || leavesThrough(segment, tm, trapezoid, false)) {
+                size_t crossed = top ? trapezoid.getTopId() : trapezoid.getBotId();
+
+                /* The first two Segments are the bounding box */
+                if(crossed != lastCrossed && crossed >= 2) {
+                    trace.segments.push_back(crossed);
+                    lastCrossed = crossed;
+
+                    const cg3::Segment2d& crossedSegment = tm.getSegment(crossed);
+                    cg3::Point2d point = crossingPoint(segment, crossedSegment, entryX, std::min(segment.p2().x(), rightP.x()));
+                    entryX = point.x();
+                    current = dag.findSegmentTrapezoid(crossedSegment, point, top);
+                    continue;
+                }
+                if(crossed < 2)
+                    break;
+            }
+
+            if(segment.p2().x() <= rightP.x())
+                break;
+
+            /* Leaving through the right side, as in followSegment */
+            entryX = rightP.x();
+            if(Utils::isPointOnTheLeft(segment, rightP))
+                current = trapezoid.getBotRightNeighbor();
+            else
+                current = trapezoid.getTopRightNeighbor();
+        }
+
+        if(segment.p1() != query.p1()) {
+            std::reverse(trace.trapezoids.begin(), trace.trapezoids.end());
+            std::reverse(trace.segments.begin(), trace.segments.end());
+        }
+    }
+
+    /**
+     * @brief Finds all the Trapezoids and all the Segments of the map crossed by a query Segment, without changing the map.
+     * @param query, the query Segment, in any direction
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @return the crossed Trapezoids and Segments, in the direction of the query
+     */
+    SegmentTrace traceSegment(const cg3::Segment2d& query, const DAG& dag, const TrapezoidalMap& tm) {
+        SegmentTrace trace;
+        traceSegment(query, dag, tm, trace);
+        return trace;
+    }
+
+    /**
+     * @brief Finds all the Trapezoids and all the Segments of the map intersecting an axis-aligned window.
+     *
+     * The Trapezoids met by the sides of the window are found tracing them with traceSegment,
+     * then the others are reached through the neighbors, visiting only the Trapezoids intersecting the window:
+     * a Trapezoid lying inside the window always has a neighbor on its left intersecting it too, and walking
+     * to the left it meets one of the sides. A Segment intersecting the window is the top or the bot
+     * of a Trapezoid intersecting it.
+     * A window crossing c Segments of the map on its sides and intersecting k Trapezoids takes O((c+1) log n + k)
+     * expected time, the marks of the visited elements are only reset where they were set.
+     * The window is clipped to the bounding box of the map; touching the window counts as intersecting it.
+     * @param window, the window
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @param result, it will contain the Trapezoids and the Segments intersecting the window (in no particular order),
+     * its previous content is discarded but its capacity is reused
+     */
+    void windowQuery(const cg3::BoundingBox2& window, const DAG& dag, const TrapezoidalMap& tm, WindowQueryResult& result) {
+        result.trapezoids.clear();
+        result.segments.clear();
+
+        const Trapezoid& boundingBox = tm.getBoundingBox();
+        cg3::BoundingBox2 clipped(
+                    cg3::Point2d(std::max(window.min().x(), tm.getLeftP(boundingBox).x()),
+                                 std::max(window.min().y(), tm.getBot(boundingBox).p1().y())),
+                    cg3::Point2d(std::min(window.max().x(), tm.getRightP(boundingBox).x()),
+                                 std::min(window.max().y(), tm.getTop(boundingBox).p1().y())));
+        if(clipped.min().x() > clipped.max().x() || clipped.min().y() > clipped.max().y())
+            return;
+
+        if(result.visitedTrapezoids.size() < tm.getTrapezoidalMapSize())
+            result.visitedTrapezoids.resize(tm.getTrapezoidalMapSize(), false);
+        if(result.visitedSegments.size() < tm.getSegmentCount())
+            result.visitedSegments.resize(tm.getSegmentCount(), false);
+
+        /* The sides of the window */
+        const cg3::Point2d corners[4] = {clipped.min(), cg3::Point2d(clipped.max().x(), clipped.min().y()),
+                                         clipped.max(), cg3::Point2d(clipped.min().x(), clipped.max().y())};
+        for(size_t i = 0; i < 4; i++) {
+            traceSegment(cg3::Segment2d(corners[i], corners[(i + 1) % 4]), dag, tm, result.edgeTrace);
+            for(const size_t& trapezoid : result.edgeTrace.trapezoids) {
+                if(!result.visitedTrapezoids[trapezoid]) {
+                    result.visitedTrapezoids[trapezoid] = true;
+                    result.trapezoids.push_back(trapezoid);
+                }
+            }
+        }
+
+        /* The found Trapezoids are also the queue of the visit */
+        for(size_t i = 0; i < result.trapezoids.size(); i++) {
+            const Trapezoid& trapezoid = tm.getTrapezoid(result.trapezoids[i]);
+            const size_t neighbors[4] = {trapezoid.getTopLeftNeighbor(), trapezoid.getBotLeftNeighbor(),
+                                         trapezoid.getTopRightNeighbor(), trapezoid.getBotRightNeighbor()};
+
+            for(const size_t& neighbor : neighbors) {
+                if(neighbor == SIZE_MAX || result.visitedTrapezoids[neighbor])
+                    continue;
+
+                const Trapezoid& other = tm.getTrapezoid(neighbor);
+                if(touchesWindow(tm.getBot(other), tm.getTop(other), tm.getLeftP(other).x(), tm.getRightP(other).x(), clipped)) {
+                    result.visitedTrapezoids[neighbor] = true;
+                    result.trapezoids.push_back(neighbor);
+                }
+            }
+        }
+
+        for(const size_t& index : result.trapezoids) {
+            const Trapezoid& trapezoid = tm.getTrapezoid(index);
+            for(const size_t& segment : {trapezoid.getTopId(), trapezoid.getBotId()}) {
+                if(segment < 2 || result.visitedSegments[segment])
+                    continue;
+
+                result.visitedSegments[segment] = true;
+                if(touchesWindow(tm.getSegment(segment), clipped))
+                    result.segments.push_back(segment);
+            }
+        }
+
+        /* Resetting only the marks set by this query */
+        for(const size_t& index : result.trapezoids) {
+            const Trapezoid& trapezoid = tm.getTrapezoid(index);
+            result.visitedTrapezoids[index] = false;
+            result.visitedSegments[trapezoid.getTopId()] = false;
+            result.visitedSegments[trapezoid.getBotId()] = false;
+        }
+    }
+
+    /**
+     * @brief Finds all the Trapezoids of the map intersecting an axis-aligned window.
+     * @param window, the window
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @return the indexes of the Trapezoids intersecting the window
+     */
+    std::vector<size_t> windowQuery(const cg3::BoundingBox2& window, const DAG& dag, const TrapezoidalMap& tm) {
+        WindowQueryResult result;
+        windowQuery(window, dag, tm, result);
+        return result.trapezoids;
+    }
+
     /**
      * @brief Updates the Trapezoidal Map and the DAG when a new Segment is added
      * @param segment, the added Segment
      * @param trapezoids, a Vector containing the indexes of the Trapezoids crossed by the Segement (from left to right)
      * @param dag, the DAG
-     * @param tm, the Drawable Trapezoidal Map (to also update the drawable versione of the trapezoid)
+     * @param tm, the Trapezoidal Map (a Drawable Trapezoidal Map will also update the drawable version of the trapezoids)
      */
-    void updateTrapezoidalMapAndDAG(const cg3::Segment2d& segment, std::vector<size_t>& trapezoids, DAG& dag, DrawableTrapezoidalMap& tm) {
-        /* A reference to the Trapezoid that is being replaced,
-         * It is needed to know in which direction to merge
-         * and to perform the update of the DAG */
-        Trapezoid replacedTrapezoid;
+    void updateTrapezoidalMapAndDAG(const cg3::Segment2d& segment, const std::vector<size_t>& trapezoids, DAG& dag, TrapezoidalMap& tm) {
+        /* The new Trapezoids refer to the Segment through its id */
+        size_t segmentId = tm.addSegment(segment);
+
+        /* What is needed of the Trapezoid that is being replaced, read before splitting it:
+         * the leaf of the DAG to replace and its top-right neighbor,
+         * which tells in which direction to merge the next one */
+        size_t replacedDAGlink;
+        size_t replacedTopRightNeighbor;
 
         std::array<size_t, 2> newTrapezoids2;
         std::array<size_t, 3> newTrapezoids3;
@@ -54,48 +373,54 @@ namespace Algorithms {
 
         /* If the new Segment is contained inside a single Trapezoid */
         if(trapezoids.size() == 1) {
-            replacedTrapezoid = tm.getTrapezoid(trapezoids[0]);
+            const Trapezoid& replacedTrapezoid = tm.getTrapezoid(trapezoids[0]);
+            bool sharedLeftP = tm.getLeftP(replacedTrapezoid) == segment.p1();
+            bool sharedRightP = tm.getRightP(replacedTrapezoid) == segment.p2();
+            replacedDAGlink = replacedTrapezoid.getDAGlink();
 
-            if(replacedTrapezoid.getLeftP() == segment.p1()) {
-                if(replacedTrapezoid.getRightP() == segment.p2()) {
-                    newTrapezoids2 = tm.split2(trapezoids[0], segment, SIZE_MAX, SIZE_MAX);
-                    dag.split2(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids2);
+            if(sharedLeftP) {
+                if(sharedRightP) {
+                    newTrapezoids2 = tm.split2(trapezoids[0], segmentId, SIZE_MAX, SIZE_MAX);
+                    dag.split2(tm, segmentId, replacedDAGlink, newTrapezoids2);
                 }
                 else {
-                    newTrapezoids3 = tm.split3R(trapezoids[0], segment, SIZE_MAX, SIZE_MAX);
-                    dag.split3R(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids3);
+                    newTrapezoids3 = tm.split3R(trapezoids[0], segmentId, SIZE_MAX, SIZE_MAX);
+                    dag.split3R(tm, segmentId, replacedDAGlink, newTrapezoids3);
                 }
             }
-            else if (replacedTrapezoid.getRightP() == segment.p2()) {
-                newTrapezoids3 = tm.split3L(trapezoids[0], segment);
-                dag.split3L(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids3);
+            else if (sharedRightP) {
+                newTrapezoids3 = tm.split3L(trapezoids[0], segmentId);
+                dag.split3L(tm, segmentId, replacedDAGlink, newTrapezoids3);
             }
             else {
-                newTrapezoids4 = tm.split4(trapezoids[0], segment);
-                dag.split4(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids4);
+                newTrapezoids4 = tm.split4(trapezoids[0], segmentId);
+                dag.split4(tm, segmentId, replacedDAGlink, newTrapezoids4);
             }
         } else {
         /* If the new Segment is contained inside multiple Trapezoids */
 
             /* Handling first Trapezoid*/
-            replacedTrapezoid = tm.getTrapezoid(trapezoids[0]);
+            const Trapezoid& firstTrapezoid = tm.getTrapezoid(trapezoids[0]);
+            bool sharedLeftP = tm.getLeftP(firstTrapezoid) == segment.p1();
+            replacedDAGlink = firstTrapezoid.getDAGlink();
+            replacedTopRightNeighbor = firstTrapezoid.getTopRightNeighbor();
 
             /* References for merging and setting neighbors */
             size_t trapezoidFromPrevSplitTop;
             size_t trapezoidFromPrevSplitBot;
 
-            if (replacedTrapezoid.getLeftP() == segment.p1()) {
-                newTrapezoids2 = tm.split2(trapezoids[0], segment, SIZE_MAX, SIZE_MAX);
+            if (sharedLeftP) {
+                newTrapezoids2 = tm.split2(trapezoids[0], segmentId, SIZE_MAX, SIZE_MAX);
 
-                dag.split2(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids2);
+                dag.split2(tm, segmentId, replacedDAGlink, newTrapezoids2);
 
                 trapezoidFromPrevSplitTop = newTrapezoids2[0];
                 trapezoidFromPrevSplitBot = newTrapezoids2[1];
             }
             else {
-                newTrapezoids3 = tm.split3L(trapezoids[0], segment);
+                newTrapezoids3 = tm.split3L(trapezoids[0], segmentId);
 
-                dag.split3L(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids3);
+                dag.split3L(tm, segmentId, replacedDAGlink, newTrapezoids3);
 
                 trapezoidFromPrevSplitTop = newTrapezoids3[1];
                 trapezoidFromPrevSplitBot = newTrapezoids3[2];
@@ -107,11 +432,13 @@ namespace Algorithms {
             /* Handling Trapezoids not in first nor in last position */
             for(size_t i=1; i<=trapezoids.size()-2; i++) {
 
-                mergeFlag = replacedTrapezoid.getTopRightNeighbor() == trapezoids[i];
+                mergeFlag = replacedTopRightNeighbor == trapezoids[i];
 
-                replacedTrapezoid = tm.getTrapezoid(trapezoids[i]);
+                const Trapezoid& replacedTrapezoid = tm.getTrapezoid(trapezoids[i]);
+                replacedDAGlink = replacedTrapezoid.getDAGlink();
+                replacedTopRightNeighbor = replacedTrapezoid.getTopRightNeighbor();
 
-                newTrapezoids2 = tm.split2(trapezoids[i], segment, trapezoidFromPrevSplitTop, trapezoidFromPrevSplitBot);
+                newTrapezoids2 = tm.split2(trapezoids[i], segmentId, trapezoidFromPrevSplitTop, trapezoidFromPrevSplitBot);
 
                 if(mergeFlag) {
                     trapezoidToMerge = tm.getTrapezoid(newTrapezoids2[0]).getBotLeftNeighbor();
@@ -124,19 +451,21 @@ namespace Algorithms {
                     newTrapezoids2[1] = trapezoidToMerge;
                 }
 
-                dag.split2(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids2);
+                dag.split2(tm, segmentId, replacedDAGlink, newTrapezoids2);
 
                 trapezoidFromPrevSplitTop = newTrapezoids2[0];
                 trapezoidFromPrevSplitBot = newTrapezoids2[1];
             }
 
             /* Handling the last Trapezoid */
-            mergeFlag = replacedTrapezoid.getTopRightNeighbor() == trapezoids[trapezoids.size()-1];
+            mergeFlag = replacedTopRightNeighbor == trapezoids.back();
 
-            replacedTrapezoid = tm.getTrapezoid(trapezoids[trapezoids.size()-1]);
+            const Trapezoid& lastTrapezoid = tm.getTrapezoid(trapezoids.back());
+            bool sharedRightP = tm.getRightP(lastTrapezoid) == segment.p2();
+            replacedDAGlink = lastTrapezoid.getDAGlink();
 
-            if(replacedTrapezoid.getRightP() == segment.p2()) {
-                newTrapezoids2 = tm.split2(trapezoids[trapezoids.size()-1], segment,
+            if(sharedRightP) {
+                newTrapezoids2 = tm.split2(trapezoids.back(), segmentId,
                                            trapezoidFromPrevSplitTop, trapezoidFromPrevSplitBot);
 
                 if(mergeFlag) {
@@ -150,9 +479,9 @@ namespace Algorithms {
                     newTrapezoids2[1] = trapezoidToMerge;
                 }
 
-                dag.split2(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids2);
+                dag.split2(tm, segmentId, replacedDAGlink, newTrapezoids2);
             } else {
-                newTrapezoids3 = tm.split3R(trapezoids[trapezoids.size()-1], segment,
+                newTrapezoids3 = tm.split3R(trapezoids.back(), segmentId,
                                       trapezoidFromPrevSplitTop, trapezoidFromPrevSplitBot);
 
                 if(mergeFlag) {
@@ -166,8 +495,409 @@ namespace Algorithms {
                     newTrapezoids3[1] = trapezoidToMerge;
                 }
 
-                dag.split3R(tm, segment, replacedTrapezoid.getDAGlink(), newTrapezoids3);
+                dag.split3R(tm, segmentId, replacedDAGlink, newTrapezoids3);
             }
         }
     }
+
+    /**
+     * @brief Adds a Segment to the Trapezoidal Map and the DAG.
+     *
+     * The buffers are owned by the caller and reused across insertions:
+     * once they have grown enough, no memory is allocated to insert a Segment
+     * (besides the growth of the map and of the DAG themselves).
+     * @param segment, the Segment (from left to right)
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map (a Drawable Trapezoidal Map will also update the drawable version of the trapezoids)
+     * @param buffers, the scratch buffers of the insertion
+     */
+    void insertSegment(const cg3::Segment2d& segment, DAG& dag, TrapezoidalMap& tm, InsertionBuffers& buffers) {
+        followSegment(segment, dag, tm, buffers.crossedTrapezoids);
+        updateTrapezoidalMapAndDAG(segment, buffers.crossedTrapezoids, dag, tm);
+
+        if(dag.isPersistent())
+            commitVersion(dag, tm);
+    }
+
+    /**
+     * @brief Enables or disables the persistent mode of both the Trapezoidal Map and the DAG.
+     *
+     * In persistent mode every insertion (insertSegment) and every removal (removeSegment)
+     * commits a new version, so the version k is the map after the first k edits
+     * and the Trapezoid containing a Point at that version is
+     * tm.getTrapezoid(dag.findPoint(point, point, k), k).
+     * The current map becomes the version 0, the maps cannot be compacted.
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @param persistent, true to enable the persistent mode
+     */
+    void setPersistent(DAG& dag, TrapezoidalMap& tm, const bool& persistent) {
+        dag.setPersistent(persistent);
+        tm.setPersistent(persistent);
+    }
+
+    /**
+     * @brief Commits the changes of the Trapezoidal Map and the DAG as a new version (in persistent mode).
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @return the new version
+     */
+    size_t commitVersion(DAG& dag, TrapezoidalMap& tm) {
+        assert(dag.isPersistent() && tm.isPersistent() && dag.getVersion() == tm.getVersion());
+
+        tm.commitVersion();
+        return dag.commitVersion();
+    }
+
+    namespace {
+        /**
+         * @brief Returns the Segments (from left to right) in a random order.
+         * @param segments, the Segments
+         * @param seed, the seed of the random permutation
+         * @return the shuffled Segments
+         */
+        std::vector<cg3::Segment2d> shuffleSegments(const std::vector<cg3::Segment2d>& segments, const unsigned int& seed) {
+            std::vector<cg3::Segment2d> shuffledSegments;
+            shuffledSegments.reserve(segments.size());
+            for(const cg3::Segment2d& segment : segments)
+                shuffledSegments.push_back(Utils::fixSegmentDirection(segment));
+
+            std::mt19937 rng(seed);
+            std::shuffle(shuffledSegments.begin(), shuffledSegments.end(), rng);
+
+            return shuffledSegments;
+        }
+
+        /**
+         * @brief Clears the Trapezoidal Map and the DAG, reserving space for a given number of Segments.
+         * @param n, the number of Segments
+         * @param dag, the DAG
+         * @param tm, the Trapezoidal Map
+         */
+        void startConstruction(const size_t& n, DAG& dag, TrapezoidalMap& tm) {
+            tm.clear();
+            dag.clear();
+
+            /* A map of n Segments has at most 3n+1 Trapezoids,
+             * the DAG has an expected size of about 9n nodes */
+            tm.reserve(3 * n + 1);
+            dag.reserve(9 * n + 1);
+
+            dag.addNode(DAGnode(0));
+        }
+    }
+
+    /**
+     * @brief Builds the Trapezoidal Map and the DAG of a set of Segments from scratch.
+     *
+     * The Segments are inserted in a random order (reproducible through the seed),
+     * so that the expected O(n log n) construction time and O(log n) query time
+     * do not depend on the order in which the Segments are given (e.g. sorted inputs).
+     * @param segments, the Segments (assumed to be non-intersecting and in general position)
+     * @param seed, the seed of the random permutation of the Segments
+     * @param dag, the DAG, it will be cleared before the construction
+     * @param tm, the Trapezoidal Map, it will be cleared before the construction
+     */
+    void buildTrapezoidalMap(const std::vector<cg3::Segment2d>& segments, const unsigned int& seed, DAG& dag, TrapezoidalMap& tm) {
+        std::vector<cg3::Segment2d> shuffledSegments = shuffleSegments(segments, seed);
+
+        startConstruction(segments.size(), dag, tm);
+
+        InsertionBuffers buffers;
+        for(const cg3::Segment2d& segment : shuffledSegments)
+            insertSegment(segment, dag, tm, buffers);
+    }
+
+    /**
+     * @brief Builds the Trapezoidal Map and the DAG like buildTrapezoidalMap,
+     * starting again with a new random order whenever the DAG gets too deep.
+     *
+     * The bound is checked on the maximum depth of the DAG (the longest path from the root to a leaf),
+     * each time the number of inserted Segments doubles and at the end, so the checks cost O(n) in total.
+     * If after i Segments it exceeds depthFactor * log2(i + 1), the construction restarts with the next seed.
+     * A random order exceeds the bound with a small probability, so the expected construction time stays O(n log n).
+     * The last of the maxAttempts constructions is completed and kept even if it exceeds the bound,
+     * which is then only checked at the end.
+     * @param segments, the Segments (assumed to be non-intersecting and in general position)
+     * @param seed, the seed of the first random permutation, the next ones use seed+1, seed+2, ...
+     * @param dag, the DAG, it will be cleared before the construction
+     * @param tm, the Trapezoidal Map, it will be cleared before the construction
+     * @param attempts, will contain the number of constructions performed
+     * @param depthFactor, the constant c of the bound c * log2(n + 1) on the depth
+     * @param maxAttempts, the maximum number of constructions (at least 1)
+     * @return true if the kept construction meets the bound, false if all the attempts exceeded it
+     */
+    bool buildDepthBoundedTrapezoidalMap(const std::vector<cg3::Segment2d>& segments, const unsigned int& seed, DAG& dag, TrapezoidalMap& tm,
+                                         size_t& attempts, const double& depthFactor, const size_t& maxAttempts) {
+        assert(maxAttempts > 0);
+
+        bool tooDeep = true;
+        InsertionBuffers buffers;
+
+        for(attempts = 0; tooDeep && attempts < maxAttempts; ) {
+            std::vector<cg3::Segment2d> shuffledSegments = shuffleSegments(segments, seed + static_cast<unsigned int>(attempts));
+            attempts++;
+
+            startConstruction(segments.size(), dag, tm);
+
+            /* The last construction is always completed */
+            bool lastAttempt = attempts == maxAttempts;
+
+            tooDeep = false;
+            size_t nextCheck = 1;
+            for(size_t i = 0; i < shuffledSegments.size() && !tooDeep; i++) {
+                insertSegment(shuffledSegments[i], dag, tm, buffers);
+
+                size_t inserted = i + 1;
+                if(inserted == shuffledSegments.size() || (!lastAttempt && inserted == nextCheck)) {
+                    double bound = depthFactor * std::log2(static_cast<double>(inserted + 1));
+                    tooDeep = dag.getStatistics().maxDepth > bound;
+                    nextCheck *= 2;
+                }
+            }
+        }
+
+        return !tooDeep;
+    }
+
+    /**
+     * @brief Removes a Segment from the Trapezoidal Map and the DAG.
+     *
+     * Only the Trapezoids above and below the Segment are recomputed:
+     * they are joined into new Trapezoids bounded by the same top and bot Segments,
+     * the ones at the endpoints are merged with their neighbors when the endpoints
+     * are not shared with other Segments, and the leaves of the replaced Trapezoids
+     * are turned into small "point" patterns locating the new ones.
+     * The cost is proportional to the number of Trapezoids around the Segment.
+     * The DAG never shrinks by itself and the removed Segment is only released (its DAGnodes can still refer to it),
+     * so when the DAG gets larger than REBUILD_DAG_SIZE_FACTOR times the number of live Trapezoids, or more than half
+     * of the Segments of the map have been released, the map is built again from its remaining Segments
+     * (rebuildTrapezoidalMap), keeping the amortized cost of a removal low, the depth of the DAG logarithmic
+     * and the Segments of the map proportional to the live ones.
+     * Otherwise, when more than 1/COMPACT_FREE_SLOT_FRACTION of the slots of the map are free, the map is compacted
+     * (compactTrapezoidalMap).
+     * Like a removal, a rebuild or a compaction changes the indexes of the Trapezoids.
+     * In persistent mode the map is never rebuilt nor compacted, since it would drop the previous versions.
+     * @param segment, the Segment to remove
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map (a Drawable Trapezoidal Map will also update the drawable version of the trapezoids)
+     * @return true if the Segment has been removed, false if it was not inside the map
+     */
+    bool removeSegment(const cg3::Segment2d& segment, DAG& dag, TrapezoidalMap& tm) {
+        cg3::Segment2d s = Utils::fixSegmentDirection(segment);
+
+        if(dag.getDAGSize() == 0)
+            return false;
+
+        size_t firstAbove = dag.findSegmentTrapezoid(s, true);
+        size_t firstBelow = dag.findSegmentTrapezoid(s, false);
+        if(tm.getBot(firstAbove) != s || tm.getTop(firstBelow) != s)
+            return false;
+
+        /* Collecting the Trapezoids above and below the Segment (from left to right) */
+        std::vector<size_t> above(1, firstAbove);
+        while(tm.getRightP(above.back()) != s.p2())
+            above.push_back(tm.getTrapezoid(above.back()).getBotRightNeighbor());
+
+        std::vector<size_t> below(1, firstBelow);
+        while(tm.getRightP(below.back()) != s.p2())
+            below.push_back(tm.getTrapezoid(below.back()).getTopRightNeighbor());
+
+        std::vector<Trapezoid> oldAbove, oldBelow;
+        oldAbove.reserve(above.size());
+        oldBelow.reserve(below.size());
+        for(const size_t& trpz : above)
+            oldAbove.push_back(tm.getTrapezoid(trpz));
+        for(const size_t& trpz : below)
+            oldBelow.push_back(tm.getTrapezoid(trpz));
+
+        /* The new Trapezoids will take the slots of the old ones,
+         * one slot will be left free */
+        std::vector<size_t> slots(above);
+        slots.insert(slots.end(), below.begin(), below.end());
+
+        /* Walking both chains at the same time: every left point of an old Trapezoid
+         * (but the first ones, which share s.p1) starts a new Trapezoid.
+         * The j-th new Trapezoid will take the j-th slot */
+        size_t m = above.size() + below.size() - 1;
+        std::vector<Trapezoid> newTrapezoids;
+        newTrapezoids.reserve(m);
+        std::vector<size_t> aboveOwner(above.size()), belowOwner(below.size());
+
+        /* Ids of the endpoints of the removed Segment */
+        size_t sLeftP = TrapezoidalMap::getLeftPointId(oldAbove[0].getBotId());
+        size_t sRightP = TrapezoidalMap::getRightPointId(oldAbove[0].getBotId());
+
+        size_t i = 0, k = 0;
+        Trapezoid current(oldAbove[0].getTopId(), oldBelow[0].getBotId(), sLeftP, sLeftP);
+        current.setTopLeftNeighbor(oldAbove[0].getTopLeftNeighbor());
+        current.setBotLeftNeighbor(oldBelow[0].getBotLeftNeighbor());
+        aboveOwner[0] = 0;
+        belowOwner[0] = 0;
+
+        while(i < above.size()-1 || k < below.size()-1) {
+            size_t j = newTrapezoids.size();
+            bool nextAbove = k == below.size()-1 ||
+                    (i < above.size()-1 && tm.getRightP(oldAbove[i]).x() < tm.getRightP(oldBelow[k]).x());
+
+            if(nextAbove) {
+                /* The right point of the Trapezoid above is a left endpoint of a Segment
+                 * or a right endpoint of the top Segment ending on the removed one */
+                current.setRightPId(oldAbove[i].getRightPId());
+                current.setTopRightNeighbor(oldAbove[i].getTopRightNeighbor());
+                current.setBotRightNeighbor(slots[j+1]);
+                newTrapezoids.push_back(current);
+
+                i++;
+                current = Trapezoid(oldAbove[i].getTopId(), oldBelow[k].getBotId(), oldAbove[i].getLeftPId(), oldAbove[i].getLeftPId());
+                current.setTopLeftNeighbor(oldAbove[i].getTopLeftNeighbor());
+                current.setBotLeftNeighbor(slots[j]);
+                aboveOwner[i] = j+1;
+            }
+            else {
+                current.setRightPId(oldBelow[k].getRightPId());
+                current.setTopRightNeighbor(slots[j+1]);
+                current.setBotRightNeighbor(oldBelow[k].getBotRightNeighbor());
+                newTrapezoids.push_back(current);
+
+                k++;
+                current = Trapezoid(oldAbove[i].getTopId(), oldBelow[k].getBotId(), oldBelow[k].getLeftPId(), oldBelow[k].getLeftPId());
+                current.setTopLeftNeighbor(slots[j]);
+                current.setBotLeftNeighbor(oldBelow[k].getBotLeftNeighbor());
+                belowOwner[k] = j+1;
+            }
+        }
+        current.setRightPId(sRightP);
+        current.setTopRightNeighbor(oldAbove.back().getTopRightNeighbor());
+        current.setBotRightNeighbor(oldBelow.back().getBotRightNeighbor());
+        newTrapezoids.push_back(current);
+
+        /* Placing the new Trapezoids inside the map, their leaves will be created later */
+        for(size_t j = 0; j < m; j++)
+            tm.replaceTrapezoid(slots[j], newTrapezoids[j]);
+
+        /* Updating neighbors' neighbors */
+        for(size_t j = 0; j < m; j++) {
+            const Trapezoid& t = tm.getTrapezoid(slots[j]);
+            if(t.getTopLeftNeighbor() != SIZE_MAX)
+                tm.getTrapezoid(t.getTopLeftNeighbor()).setTopRightNeighbor(slots[j]);
+            if(t.getBotLeftNeighbor() != SIZE_MAX)
+                tm.getTrapezoid(t.getBotLeftNeighbor()).setBotRightNeighbor(slots[j]);
+            if(t.getTopRightNeighbor() != SIZE_MAX)
+                tm.getTrapezoid(t.getTopRightNeighbor()).setTopLeftNeighbor(slots[j]);
+            if(t.getBotRightNeighbor() != SIZE_MAX)
+                tm.getTrapezoid(t.getBotRightNeighbor()).setBotLeftNeighbor(slots[j]);
+        }
+
+        /* The spare slot will be reused by the next added Trapezoid */
+        tm.freeTrapezoid(slots[m]);
+
+        /* Merging at the endpoints if they are not shared with other Segments */
+        size_t first = slots[0];
+        size_t last = slots[m-1];
+
+        size_t leftNeighbor = oldAbove[0].getTopLeftNeighbor();
+        if(leftNeighbor != SIZE_MAX && leftNeighbor == oldBelow[0].getBotLeftNeighbor()) {
+            tm.merge(leftNeighbor, first);
+            if(m == 1)
+                last = leftNeighbor;
+            first = leftNeighbor;
+        }
+
+        size_t rightNeighbor = oldAbove.back().getTopRightNeighbor();
+        if(rightNeighbor != SIZE_MAX && rightNeighbor == oldBelow.back().getBotRightNeighbor()) {
+            size_t rightNeighborNode = tm.getTrapezoid(rightNeighbor).getDAGlink();
+            tm.merge(last, rightNeighbor);
+            dag.splitX(tm, rightNeighborNode, std::vector<size_t>(), std::vector<size_t>(1, last));
+        }
+
+        /* Replacing the leaves of the old Trapezoids with the patterns locating the new ones */
+        std::vector<size_t> finalIndexes(slots.begin(), slots.begin() + m);
+        finalIndexes[0] = first;
+        finalIndexes[m-1] = last;
+
+        for(size_t side = 0; side < 2; side++) {
+            const std::vector<Trapezoid>& oldTrapezoids = side == 0 ? oldAbove : oldBelow;
+            const std::vector<size_t>& owners = side == 0 ? aboveOwner : belowOwner;
+
+            for(size_t t = 0; t < oldTrapezoids.size(); t++) {
+                size_t firstOwner = owners[t];
+                size_t lastOwner = t+1 < owners.size() ? owners[t+1]-1 : m-1;
+
+                std::vector<size_t> points;
+                std::vector<size_t> trpzs;
+                for(size_t j = firstOwner; j <= lastOwner; j++) {
+                    if(j > firstOwner)
+                        points.push_back(newTrapezoids[j].getLeftPId());
+                    trpzs.push_back(finalIndexes[j]);
+                }
+                dag.splitX(tm, oldTrapezoids[t].getDAGlink(), points, trpzs);
+            }
+        }
+
+        tm.releaseSegment(oldAbove[0].getBotId());
+
+        if(dag.isPersistent())
+            commitVersion(dag, tm);
+        else if(dag.getDAGSize() > REBUILD_DAG_SIZE_FACTOR * tm.liveTrapezoidCount() ||
+                tm.getReleasedSegmentCount() > tm.getSegmentCount() / 2)
+            rebuildTrapezoidalMap(dag, tm, static_cast<unsigned int>(dag.getDAGSize()));
+        else if(COMPACT_FREE_SLOT_FRACTION * (tm.getTrapezoidalMapSize() - tm.liveTrapezoidCount()) > tm.getTrapezoidalMapSize())
+            compactTrapezoidalMap(dag, tm);
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the Segments (from left to right) still inside the Trapezoidal Map,
+     * the ones bounding at least a live Trapezoid (but the bounding box)
+     * @param tm, the Trapezoidal Map
+     * @return the Segments, in the order of their ids
+     */
+    std::vector<cg3::Segment2d> getMapSegments(const TrapezoidalMap& tm) {
+        std::vector<bool> used(tm.getSegmentCount(), false);
+        for(size_t i = 0; i < tm.getTrapezoidalMapSize(); i++) {
+            if(tm.isFreeSlot(i))
+                continue;
+            used[tm.getTrapezoid(i).getTopId()] = true;
+            used[tm.getTrapezoid(i).getBotId()] = true;
+        }
+
+        /* The first two Segments are the bounding box */
+        std::vector<cg3::Segment2d> segments;
+        for(size_t id = 2; id < used.size(); id++) {
+            if(used[id])
+                segments.push_back(tm.getSegment(id));
+        }
+        return segments;
+    }
+
+    /**
+     * @brief Builds the Trapezoidal Map and the DAG again from the Segments they contain,
+     * dropping the DAGnodes left behind by the removals and the free slots of the map.
+     * The indexes of the Trapezoids and the ids of the Segments change.
+     * It cannot be used in persistent mode.
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     * @param seed, the seed of the random permutation of the Segments
+     */
+    void rebuildTrapezoidalMap(DAG& dag, TrapezoidalMap& tm, const unsigned int& seed) {
+        assert(!dag.isPersistent());
+        buildTrapezoidalMap(getMapSegments(tm), seed, dag, tm);
+    }
+
+    /**
+     * @brief Removes the "deleted" Trapezoids from the Trapezoidal Map,
+     * updating the leaves of the DAG pointing to the moved Trapezoids.
+     *
+     * After it, the indexes of the Trapezoids go from 0 to the number of live Trapezoids.
+     * removeSegment calls it when too many slots are free.
+     * It cannot be used in persistent mode.
+     * @param dag, the DAG
+     * @param tm, the Trapezoidal Map
+     */
+    void compactTrapezoidalMap(DAG& dag, TrapezoidalMap& tm) {
+        for(const size_t& index : tm.compact())
+            dag.updateNode(DAGnode(index), tm.getTrapezoid(index).getDAGlink());
+    }
 }
@@ -1,13 +1,63 @@
 #ifndef ALGORITHMS_H
 #define ALGORITHMS_H
 
-#import "drawables/drawabletrapezoidalmap.h"
 #import "data_structures/dag.h"
 
+#include <cg3/geometry/bounding_box2.h>
+
 namespace Algorithms {
-    std::vector<size_t> followSegment(const cg3::Segment2d& segment, DAG& dag, TrapezoidalMap& tm);
+    /* Scratch buffers of the insertion of a Segment, owned by the caller and reused across insertions */
+    struct InsertionBuffers {
+        /* Trapezoids crossed by the inserted Segment (from left to right) */
+        std::vector<size_t> crossedTrapezoids;
+    };
+
+    /* Result of the trace of a query Segment through the map */
+    struct SegmentTrace {
+        /* Trapezoids crossed by the query, in the order they are met going from its first endpoint to the second one */
+        std::vector<size_t> trapezoids;
+        /* Ids (inside the TrapezoidalMap) of the Segments of the map crossed by the query, in the same order */
+        std::vector<size_t> segments;
+    };
+
+    /* Result of a window query, kept by the caller to reuse its buffers across queries */
+    struct WindowQueryResult {
+        /* Trapezoids intersecting the window */
+        std::vector<size_t> trapezoids;
+        /* Ids (inside the TrapezoidalMap) of the Segments of the map intersecting the window */
+        std::vector<size_t> segments;
+
+        /* Scratch buffers: the trace of an edge of the window and the marks of the visited elements */
+        SegmentTrace edgeTrace;
+        std::vector<bool> visitedTrapezoids;
+        std::vector<bool> visitedSegments;
+    };
+
+    void followSegment(const cg3::Segment2d& segment, const DAG& dag, const TrapezoidalMap& tm, std::vector<size_t>& trapezoids);
+    std::vector<size_t> followSegment(const cg3::Segment2d& segment, const DAG& dag, const TrapezoidalMap& tm);
+
+    void traceSegment(const cg3::Segment2d& query, const DAG& dag, const TrapezoidalMap& tm, SegmentTrace& trace);
+    SegmentTrace traceSegment(const cg3::Segment2d& query, const DAG& dag, const TrapezoidalMap& tm);
+
+    void windowQuery(const cg3::BoundingBox2& window, const DAG& dag, const TrapezoidalMap& tm, WindowQueryResult& result);
+    std::vector<size_t> windowQuery(const cg3::BoundingBox2& window, const DAG& dag, const TrapezoidalMap& tm);
+
+    void updateTrapezoidalMapAndDAG(const cg3::Segment2d& segment, const std::vector<size_t>& trapezoids, DAG& dag, TrapezoidalMap& tm);
+
+    void insertSegment(const cg3::Segment2d& segment, DAG& dag, TrapezoidalMap& tm, InsertionBuffers& buffers);
+
+    void setPersistent(DAG& dag, TrapezoidalMap& tm, const bool& persistent);
+    size_t commitVersion(DAG& dag, TrapezoidalMap& tm);
+
+    void buildTrapezoidalMap(const std::vector<cg3::Segment2d>& segments, const unsigned int& seed, DAG& dag, TrapezoidalMap& tm);
+    bool buildDepthBoundedTrapezoidalMap(const std::vector<cg3::Segment2d>& segments, const unsigned int& seed, DAG& dag, TrapezoidalMap& tm,
+                                         size_t& attempts, const double& depthFactor = 6.0, const size_t& maxAttempts = 16);
+
+    bool removeSegment(const cg3::Segment2d& segment, DAG& dag, TrapezoidalMap& tm);
+    std::vector<cg3::Segment2d> getMapSegments(const TrapezoidalMap& tm);
+    void rebuildTrapezoidalMap(DAG& dag, TrapezoidalMap& tm, const unsigned int& seed = 0);
 
-    void updateTrapezoidalMapAndDAG(const cg3::Segment2d& segment, std::vector<size_t>& trapezoids, DAG& dag, DrawableTrapezoidalMap& tm);
+    void compactTrapezoidalMap(DAG& dag, TrapezoidalMap& tm);
 }
 
 #endif // ALGORITHMS_H
@@ -0,0 +1,543 @@
+#include "segment_intersections.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <set>
+
+#include "utils/expansion.h"
+#include "utils/utils.h"
+
+namespace Algorithms {
+    namespace {
+        enum EventType {crossingEvent, insertionEvent, removalEvent};
+
+        /* Relative error of the floating point computations approximating the crossing points and the orientations */
+        const double APPROXIMATION_ERROR_BOUND = 16 * std::numeric_limits<double>::epsilon();
+
+        /* Relative distance within which a segment is considered close to an event point,
+           larger than the rounding errors of a predicate that is not exact */
+        const double NEAR_POINT_TOLERANCE = 1024 * std::numeric_limits<double>::epsilon();
+
+        /* Index standing for the sweep point when the status is searched */
+        const size_t SWEEP_POINT_PROBE = SIZE_MAX;
+
+        /**
+         * @brief An event of the sweep, at an endpoint of a segment or at the crossing of the segments first and second.
+         * The coordinates of a crossing are approximated within error, the exact ones are computed
+         * only when the approximation cannot tell two points apart
+         */
+        struct Event {
+            double x;
+            double y;
+            double error;
+            EventType type;
+            size_t first;
+            size_t second;
+        };
+
+        /**
+         * @brief A point given exactly through its homogeneous coordinates (x / w, y / w), with w > 0
+         */
+        struct ExactPoint {
+            Utils::Expansion x;
+            Utils::Expansion y;
+            Utils::Expansion w;
+        };
+
+        /**
+         * @brief A slot of the status: when only crossings happen at an event point,
+         * the segments are written again in their new order inside the same slots
+         */
+        struct StatusSlot {
+            mutable size_t segment;
+        };
+
+        /**
+         * @brief The sweep, the segments are stored from their left (lexicographically smaller) endpoint.
+         * All the events at the same point are handled together: the segments passing through the point
+         * are taken out of the status and the ones going on are put back in their order after the point,
+         * so the status is always ordered along the sweep line
+         */
+        class Sweep {
+            public:
+                Sweep(const std::vector<cg3::Segment2d>& segments, SegmentIntersectionPredicate intersectionPredicate,
+                      std::vector<std::pair<size_t, size_t>>& intersections);
+
+                void run();
+            private:
+                struct EventComparator {
+                    const Sweep* sweep;
+
+                    bool operator()(const Event& a, const Event& b) const {
+                        return sweep->comparePoints(a, b) > 0;
+                    }
+                };
+
+                struct StatusComparator {
+                    const Sweep* sweep;
+
+                    bool operator()(const StatusSlot& a, const StatusSlot& b) const {
+                        return sweep->compareSegments(a.segment, b.segment) < 0;
+                    }
+                };
+
+                typedef std::set<StatusSlot, StatusComparator> Status;
+
+                const std::vector<cg3::Segment2d>& segments;
+                SegmentIntersectionPredicate intersectionPredicate;
+                std::vector<std::pair<size_t, size_t>>& intersections;
+
+                std::vector<cg3::Point2d> leftPoints;
+                std::vector<cg3::Point2d> rightPoints;
+
+                Status status;
+                std::vector<Status::iterator> slots;
+                /* Segments ending at the sweep point and segments going on after it */
+                std::vector<char> ending;
+                std::vector<char> through;
+
+                std::priority_queue<Event, std::vector<Event>, EventComparator> events;
+
+                /* The sweep point, exact when it is not a crossing, and a segment of the status passing through it
+                   (SIZE_MAX if the events are only insertions). The exact coordinates of a crossing are computed
+                   the first time they are needed */
+                Event sweepEvent;
+                size_t sweepSegment;
+                mutable ExactPoint exactSweepPoint;
+                mutable bool exactSweepPointComputed;
+
+                /* Buffers of handleEventPoint */
+                std::vector<size_t> starting;
+                std::vector<size_t> touching;
+                std::vector<size_t> continuing;
+                std::vector<size_t> near;
+
+                void exactPoint(const Event& event, ExactPoint& point) const;
+                int comparePoints(const Event& a, const Event& b) const;
+
+                int orientation(const size_t& s, const cg3::Point2d& p) const;
+                int sweepOrientation(const size_t& s) const;
+                int compareSegments(const size_t& a, const size_t& b) const;
+                bool passesNearSweepPoint(const size_t& s) const;
+                bool needSwap(const size_t& below, const size_t& above) const;
+
+                void checkPair(const size_t& a, const size_t& b);
+                void checkAdjacentPair(const size_t& below, const size_t& above);
+                void handleEventPoint();
+        };
+
+        /**
+         * @brief Compares two approximated coordinates
+         * @return -1 or 1 if a is surely smaller or larger than b, 0 if they are within their errors
+         */
+        inline int compareApproximations(const double& a, const double& aError, const double& b, const double& bError) {
+            if(std::fabs(a - b) <= 2 * (aError + bError))
+                return 0;
+            return a < b ? -1 : 1;
+        }
+
+        /**
+         * @brief Compares exactly two homogeneous coordinates a / aw and b / bw, with aw, bw > 0
+         * @return -1, 0 or 1
+         */
+        inline int compareHomogeneous(const Utils::Expansion& a, const Utils::Expansion& aw,
+                                      const Utils::Expansion& b, const Utils::Expansion& bw) {
+            return Utils::expansionSign(Utils::subtractExpansions(Utils::multiplyExpansions(a, bw),
+                                                                  Utils::multiplyExpansions(b, aw)));
+        }
+
+        Sweep::Sweep(const std::vector<cg3::Segment2d>& segments, SegmentIntersectionPredicate intersectionPredicate,
+                     std::vector<std::pair<size_t, size_t>>& intersections) :
+            segments(segments),
+            intersectionPredicate(intersectionPredicate),
+            intersections(intersections),
+            status(StatusComparator{this}),
+            slots(segments.size()),
+            ending(segments.size(), false),
+            through(segments.size(), false),
+            events(EventComparator{this})
+        {
+            leftPoints.reserve(segments.size());
+            rightPoints.reserve(segments.size());
+            for(const cg3::Segment2d& segment : segments) {
+                if(segment.p2() < segment.p1()) {
+                    leftPoints.push_back(segment.p2());
+                    rightPoints.push_back(segment.p1());
+                }
+                else {
+                    leftPoints.push_back(segment.p1());
+                    rightPoints.push_back(segment.p2());
+                }
+            }
+        }
+
+        void Sweep::run() {
+            /* Degenerate segments cannot intersect properly any other segment */
+            for(size_t i=0; i<segments.size(); i++) {
+                if(leftPoints[i] != rightPoints[i]) {
+                    events.push(Event{leftPoints[i].x(), leftPoints[i].y(), 0, insertionEvent, i, i});
+                    events.push(Event{rightPoints[i].x(), rightPoints[i].y(), 0, removalEvent, i, i});
+                }
+            }
+
+            while(!events.empty()) {
+                sweepEvent = events.top();
+                sweepSegment = SIZE_MAX;
+                starting.clear();
+
+                /* Taking all the events at the same point, an endpoint is preferred to a crossing to stand for it */
+                do {
+                    Event event = events.top();
+                    events.pop();
+
+                    if(event.type == insertionEvent) {
+                        starting.push_back(event.first);
+                    }
+                    else {
+                        sweepSegment = event.first;
+                        if(event.type == removalEvent)
+                            ending[event.first] = true;
+                    }
+
+                    if(sweepEvent.type == crossingEvent && event.type != crossingEvent)
+                        sweepEvent = event;
+                } while(!events.empty() && comparePoints(events.top(), sweepEvent) == 0);
+
+                exactSweepPointComputed = false;
+                handleEventPoint();
+            }
+
+            std::sort(intersections.begin(), intersections.end());
+            intersections.erase(std::unique(intersections.begin(), intersections.end()), intersections.end());
+        }
+
+        /**
+         * @brief Computes the exact point of an event. The crossing of the segments a and b is
+         * (a2 * d1 - a1 * d2) / (d1 - d2), where d1 and d2 are the orientations of a1 and a2 with respect to b
+         */
+        void Sweep::exactPoint(const Event& event, ExactPoint& point) const {
+            if(event.type != crossingEvent) {
+                point.x.assign(event.x != 0 ? 1 : 0, event.x);
+                point.y.assign(event.y != 0 ? 1 : 0, event.y);
+                point.w.assign(1, 1.0);
+                return;
+            }
+
+            const cg3::Point2d& a1 = leftPoints[event.first];
+            const cg3::Point2d& a2 = rightPoints[event.first];
+            const cg3::Point2d& b1 = leftPoints[event.second];
+            const cg3::Point2d& b2 = rightPoints[event.second];
+
+            Utils::Expansion d1 = Utils::orientationExpansion(b1.x(), b1.y(), b2.x(), b2.y(), a1.x(), a1.y());
+            Utils::Expansion d2 = Utils::orientationExpansion(b1.x(), b1.y(), b2.x(), b2.y(), a2.x(), a2.y());
+
+            point.x = Utils::subtractExpansions(Utils::scaleExpansion(d1, a2.x()), Utils::scaleExpansion(d2, a1.x()));
+            point.y = Utils::subtractExpansions(Utils::scaleExpansion(d1, a2.y()), Utils::scaleExpansion(d2, a1.y()));
+            point.w = Utils::subtractExpansions(d1, d2);
+
+            if(Utils::expansionSign(point.w) < 0) {
+                point.x = Utils::scaleExpansion(point.x, -1);
+                point.y = Utils::scaleExpansion(point.y, -1);
+                point.w = Utils::scaleExpansion(point.w, -1);
+            }
+        }
+
+        /**
+         * @brief Compares exactly the points of two events, lexicographically
+         * @return -1, 0 or 1
+         */
+        int Sweep::comparePoints(const Event& a, const Event& b) const {
+            if(a.type != crossingEvent && b.type != crossingEvent) {
+                if(a.x != b.x)
+                    return a.x < b.x ? -1 : 1;
+                if(a.y != b.y)
+                    return a.y < b.y ? -1 : 1;
+                return 0;
+            }
+
+            /* The same crossing, scheduled each time its segments became adjacent */
+            if(a.type == b.type && std::min(a.first, a.second) == std::min(b.first, b.second) &&
+                    std::max(a.first, a.second) == std::max(b.first, b.second))
+                return 0;
+
+            int result = compareApproximations(a.x, a.error, b.x, b.error);
+            if(result != 0)
+                return result;
+
+            ExactPoint exactA, exactB;
+            exactPoint(a, exactA);
+            exactPoint(b, exactB);
+
+            result = compareHomogeneous(exactA.x, exactA.w, exactB.x, exactB.w);
+            if(result != 0)
+                return result;
+
+            result = compareApproximations(a.y, a.error, b.y, b.error);
+            if(result != 0)
+                return result;
+            return compareHomogeneous(exactA.y, exactA.w, exactB.y, exactB.w);
+        }
+
+        /**
+         * @brief Exact orientation of a point with respect to a segment, directed from its left endpoint
+         * @return 1 if the point is above the segment, -1 if it is below, 0 if they are collinear
+         */
+        int Sweep::orientation(const size_t& s, const cg3::Point2d& p) const {
+            double side = Utils::orientation(leftPoints[s].x(), leftPoints[s].y(), rightPoints[s].x(), rightPoints[s].y(),
+                                             p.x(), p.y());
+            return side > 0 ? 1 : (side < 0 ? -1 : 0);
+        }
+
+        /**
+         * @brief Exact orientation of the sweep point with respect to a segment, directed from its left endpoint.
+         * A crossing is first tested with its approximated coordinates
+         * @return 1 if the sweep point is above the segment, -1 if it is below, 0 if it lies on its line
+         */
+        int Sweep::sweepOrientation(const size_t& s) const {
+            if(sweepEvent.type != crossingEvent)
+                return orientation(s, cg3::Point2d(sweepEvent.x, sweepEvent.y));
+            if(s == sweepEvent.first || s == sweepEvent.second)
+                return 0;
+
+            const cg3::Point2d& l = leftPoints[s];
+            const cg3::Point2d& r = rightPoints[s];
+
+            double dx = r.x() - l.x();
+            double dy = r.y() - l.y();
+            double detLeft = dx * (sweepEvent.y - l.y());
+            double detRight = dy * (sweepEvent.x - l.x());
+            double det = detLeft - detRight;
+            double errorBound = APPROXIMATION_ERROR_BOUND * (std::fabs(detLeft) + std::fabs(detRight)) +
+                                2 * (std::fabs(dx) + std::fabs(dy)) * sweepEvent.error;
+            if(std::fabs(det) > errorBound)
+                return det > 0 ? 1 : -1;
+
+            if(!exactSweepPointComputed) {
+                exactPoint(sweepEvent, exactSweepPoint);
+                exactSweepPointComputed = true;
+            }
+
+            /* w * (l.x * r.y - l.y * r.x) + x * (l.y - r.y) + y * (r.x - l.x) */
+            const ExactPoint& p = exactSweepPoint;
+            Utils::Expansion exact = Utils::subtractExpansions(Utils::scaleExpansion(Utils::scaleExpansion(p.w, l.x()), r.y()),
+                                                               Utils::scaleExpansion(Utils::scaleExpansion(p.w, l.y()), r.x()));
+            exact = Utils::sumExpansions(exact, Utils::subtractExpansions(Utils::scaleExpansion(p.x, l.y()),
+                                                                          Utils::scaleExpansion(p.x, r.y())));
+            exact = Utils::sumExpansions(exact, Utils::subtractExpansions(Utils::scaleExpansion(p.y, r.x()),
+                                                                          Utils::scaleExpansion(p.y, l.x())));
+            return Utils::expansionSign(exact);
+        }
+
+        /**
+         * @brief Compares two segments along the sweep line just after the sweep point.
+         * The segments going on after the sweep point are ordered by their direction (collinear ones by index),
+         * and they are compared to the other ones through the side of the sweep point.
+         * The sweep point itself (SWEEP_POINT_PROBE) is equivalent to all the segments passing through it
+         * @return a negative value if a is below b, a positive one if it is above, 0 if they are equivalent
+         */
+        int Sweep::compareSegments(const size_t& a, const size_t& b) const {
+            if(a == b)
+                return 0;
+            if(a == SWEEP_POINT_PROBE)
+                return sweepOrientation(b);
+            if(b == SWEEP_POINT_PROBE)
+                return -sweepOrientation(a);
+
+            if(through[a] && through[b]) {
+                int side = orientation(a, rightPoints[b]);
+                if(side == 0)
+                    return a < b ? -1 : 1;
+                return -side;
+            }
+            if(through[a])
+                return sweepOrientation(b) > 0 ? 1 : -1;
+            if(through[b])
+                return sweepOrientation(a) > 0 ? -1 : 1;
+
+            /* Two segments not passing through the sweep point are never compared by the sweep */
+            int sideA = sweepOrientation(a);
+            int sideB = sweepOrientation(b);
+            if(sideA != sideB)
+                return sideA > sideB ? -1 : 1;
+            return a < b ? -1 : 1;
+        }
+
+        /**
+         * @brief Checks if a segment passes close to the sweep point, within a tolerance relative to the coordinates
+         */
+        bool Sweep::passesNearSweepPoint(const size_t& s) const {
+            const cg3::Point2d& l = leftPoints[s];
+            const cg3::Point2d& r = rightPoints[s];
+
+            double dx = r.x() - l.x();
+            double dy = r.y() - l.y();
+            double det = dx * (sweepEvent.y - l.y()) - dy * (sweepEvent.x - l.x());
+            double scale = std::fabs(dx) * (std::fabs(sweepEvent.y) + std::fabs(l.y())) +
+                           std::fabs(dy) * (std::fabs(sweepEvent.x) + std::fabs(l.x()));
+            return std::fabs(det) <= NEAR_POINT_TOLERANCE * scale;
+        }
+
+        /**
+         * @brief Checks if two adjacent segments properly cross before one of them ends
+         */
+        bool Sweep::needSwap(const size_t& below, const size_t& above) const {
+            if(rightPoints[below] < rightPoints[above])
+                return orientation(above, rightPoints[below]) > 0;
+            if(rightPoints[above] < rightPoints[below])
+                return orientation(below, rightPoints[above]) < 0;
+            return false;
+        }
+
+        /**
+         * @brief Reports a pair of segments if they intersect, the predicate always gets them in order of index
+         */
+        void Sweep::checkPair(const size_t& a, const size_t& b) {
+            size_t first = std::min(a, b);
+            size_t second = std::max(a, b);
+            if(intersectionPredicate(segments[first], segments[second]))
+                intersections.push_back(std::make_pair(first, second));
+        }
+
+        /**
+         * @brief Reports a pair of segments that became adjacent and schedules their crossing, if any.
+         * The crossing is approximated as a1 + t * (a2 - a1), with t = d1 / (d1 - d2) computed from
+         * the exact orientations d1 and d2 of a1 and a2 with respect to the other segment
+         */
+        void Sweep::checkAdjacentPair(const size_t& below, const size_t& above) {
+            checkPair(below, above);
+            if(!needSwap(below, above))
+                return;
+
+            const cg3::Point2d& a1 = leftPoints[below];
+            const cg3::Point2d& a2 = rightPoints[below];
+            const cg3::Point2d& b1 = leftPoints[above];
+            const cg3::Point2d& b2 = rightPoints[above];
+
+            double e1[12], e2[12];
+            size_t length1 = Utils::orientationExpansion(b1.x(), b1.y(), b2.x(), b2.y(), a1.x(), a1.y(), e1);
+            size_t length2 = Utils::orientationExpansion(b1.x(), b1.y(), b2.x(), b2.y(), a2.x(), a2.y(), e2);
+            double d1 = Utils::estimateExpansion(e1, length1);
+            double d2 = Utils::estimateExpansion(e2, length2);
+
+            /* d1 and d2 have opposite signs, so t is computed without cancellation */
+            double t = d1 / (d1 - d2);
+            double error = APPROXIMATION_ERROR_BOUND * (std::fabs(a1.x()) + std::fabs(a2.x()) +
+                                                        std::fabs(a1.y()) + std::fabs(a2.y()));
+            events.push(Event{a1.x() + t * (a2.x() - a1.x()), a1.y() + t * (a2.y() - a1.y()), error,
+                              crossingEvent, below, above});
+        }
+
+        /**
+         * @brief Handles all the events at the sweep point.
+         * Every pair of segments passing through the point (or starting from it) is reported,
+         * together with the pairs made with the segments passing close to it, then the segments
+         * going on are put back in their new order and the pairs of segments that became adjacent are checked
+         */
+        void Sweep::handleEventPoint() {
+            /* The segments of the status passing through the point are contiguous */
+            std::pair<Status::iterator, Status::iterator> range;
+            if(sweepSegment != SIZE_MAX) {
+                range.first = slots[sweepSegment];
+                range.second = std::next(range.first);
+            }
+            else {
+                range.first = status.lower_bound(StatusSlot{SWEEP_POINT_PROBE});
+                range.second = range.first;
+            }
+            while(range.first != status.begin() && sweepOrientation(std::prev(range.first)->segment) == 0)
+                range.first--;
+            while(range.second != status.end() && sweepOrientation(range.second->segment) == 0)
+                range.second++;
+
+            touching.assign(starting.begin(), starting.end());
+            bool changed = !starting.empty();
+            for(Status::iterator it = range.first; it != range.second; it++) {
+                touching.push_back(it->segment);
+                changed |= ending[it->segment] != 0;
+            }
+
+            for(size_t i=0; i<touching.size(); i++)
+                for(size_t j=i+1; j<touching.size(); j++)
+                    checkPair(touching[i], touching[j]);
+
+            /* A predicate that is not exact may see the segments passing within rounding error of the point
+               touching it (e.g. an endpoint on a segment of a decimal grid), they are next to the ones through it */
+            near.clear();
+            for(Status::iterator it = range.first; it != status.begin() && passesNearSweepPoint(std::prev(it)->segment); it--)
+                near.push_back(std::prev(it)->segment);
+            for(Status::iterator it = range.second; it != status.end() && passesNearSweepPoint(it->segment); it++)
+                near.push_back(it->segment);
+            for(const size_t& s : near)
+                for(const size_t& t : touching)
+                    checkPair(s, t);
+
+            continuing.clear();
+            for(const size_t& s : touching) {
+                if(!ending[s]) {
+                    continuing.push_back(s);
+                    through[s] = true;
+                }
+                ending[s] = false;
+            }
+
+            std::sort(continuing.begin(), continuing.end(), [this](const size_t& a, const size_t& b) {
+                return compareSegments(a, b) < 0;
+            });
+
+            Status::iterator above = range.second;
+            if(changed) {
+                above = status.erase(range.first, range.second);
+                for(const size_t& s : continuing)
+                    slots[s] = status.insert(above, StatusSlot{s});
+            }
+            else {
+                /* Only crossings: the same slots take the segments in their new order */
+                Status::iterator it = range.first;
+                for(const size_t& s : continuing) {
+                    it->segment = s;
+                    slots[s] = it++;
+                }
+            }
+
+            if(continuing.empty()) {
+                if(above != status.begin() && above != status.end())
+                    checkAdjacentPair(std::prev(above)->segment, above->segment);
+            }
+            else {
+                Status::iterator lowest = slots[continuing.front()];
+                Status::iterator highest = slots[continuing.back()];
+                if(lowest != status.begin())
+                    checkAdjacentPair(std::prev(lowest)->segment, lowest->segment);
+                if(std::next(highest) != status.end())
+                    checkAdjacentPair(highest->segment, std::next(highest)->segment);
+            }
+
+            for(const size_t& s : continuing)
+                through[s] = false;
+        }
+    }
+
+    /**
+     * @brief Finds all the pairs of intersecting segments with a sweep line (Bentley-Ottmann), in O((n + k) log n).
+     * The events are ordered with exact arithmetic, also at the crossing points, and the order of the segments
+     * along the sweep line is decided with exact orientation tests, so every pair of segments sharing a point is tested.
+     * The predicate is also tested on the pairs of segments that become adjacent along the sweep line
+     * and on the segments passing within rounding error of an event point,
+     * but a pair within rounding error of touching elsewhere may still be missed if the predicate is not exact
+     * @param segments, the segments
+     * @param intersectionPredicate, the predicate deciding if two segments intersect,
+     * it must not be true for segments that do not share any point
+     * @param intersections, will contain the pairs (i, j), with i < j, of the indexes of the intersecting segments,
+     * sorted in lexicographic order
+     */
+    void findSegmentIntersections(const std::vector<cg3::Segment2d>& segments,
+                                  SegmentIntersectionPredicate intersectionPredicate,
+                                  std::vector<std::pair<size_t, size_t>>& intersections) {
+        intersections.clear();
+
+        Sweep sweep(segments, intersectionPredicate, intersections);
+        sweep.run();
+    }
+}
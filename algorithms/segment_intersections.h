@@ -0,0 +1,17 @@
+#ifndef SEGMENT_INTERSECTIONS_H
+#define SEGMENT_INTERSECTIONS_H
+
+#include <utility>
+#include <vector>
+
+#include <cg3/geometry/segment2.h>
+
+namespace Algorithms {
+    typedef bool (*SegmentIntersectionPredicate)(const cg3::Segment2d&, const cg3::Segment2d&);
+
+    void findSegmentIntersections(const std::vector<cg3::Segment2d>& segments,
+                                  SegmentIntersectionPredicate intersectionPredicate,
+                                  std::vector<std::pair<size_t, size_t>>& intersections);
+}
+
+#endif // SEGMENT_INTERSECTIONS_H
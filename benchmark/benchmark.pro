@@ -0,0 +1,75 @@
+# Command line benchmark of the construction and of the queries of the trapezoidal map.
+# It only uses the headless core (algorithms and data structures) and the vertex arrays of the drawables, without Qt and OpenGL.
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle qt
+
+TARGET = trapezoidalmap_benchmark
+
+# Release configuration
+CONFIG(release, debug|release){
+    DEFINES += NDEBUG
+}
+
+# cg3lib works with c++11
+CONFIG += c++11
+
+# DAG::locate answers batches of queries on multiple threads
+CONFIG += thread
+
+# The exact orientation test (Utils::orientation) needs every floating point
+# operation to be rounded on its own, without fused multiply-adds
+unix {
+    QMAKE_CXXFLAGS += -ffp-contract=off
+}
+
+# Uncomment next line to count the orientation tests solved by the fast path (fast_orientation_ratio)
+#DEFINES += ORIENTATION_STATISTICS
+
+# Uncomment next line to count the queries answered by the DAG and the nodes they visit
+#DEFINES += DAG_STATISTICS
+
+# Uncomment next line to store the indexes inside Trapezoids and DAGnodes on 64 bits instead of 32
+#DEFINES += TRAPEZOIDALMAP_64BIT_INDEXES
+
+CONFIG += CG3_CORE
+
+include (../cg3lib/cg3.pri)
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../algorithms/algorithms.cpp \
+    ../data_structures/compact_dag.cpp \
+    ../data_structures/dag.cpp \
+    ../data_structures/dag_jump_table.cpp \
+    ../data_structures/dagnode.cpp \
+    ../data_structures/trapezoid.cpp \
+    ../data_structures/trapezoidalmap.cpp \
+    ../data_structures/walking_locator.cpp \
+    ../drawables/drawabletrapezoid.cpp \
+    ../drawables/trapezoidvertexbuffer.cpp \
+    ../drawables/trapezoidvertexupdater.cpp \
+    ../utils/utils.cpp \
+    main.cpp \
+    workloads.cpp
+
+HEADERS += \
+    ../algorithms/algorithms.h \
+    ../data_structures/compact_dag.h \
+    ../data_structures/dag.h \
+    ../data_structures/dag_jump_table.h \
+    ../data_structures/dagnode.h \
+    ../data_structures/stored_index.h \
+    ../data_structures/trapezoid.h \
+    ../data_structures/trapezoidalmap.h \
+    ../data_structures/trapezoidalmap_observer.h \
+    ../data_structures/version_history.h \
+    ../data_structures/walking_locator.h \
+    ../drawables/drawabletrapezoid.h \
+    ../drawables/trapezoidvertexbuffer.h \
+    ../drawables/trapezoidvertexupdater.h \
+    ../utils/expansion.h \
+    ../utils/utils.h \
+    workloads.h
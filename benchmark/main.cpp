@@ -0,0 +1,442 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "algorithms/algorithms.h"
+#include "data_structures/compact_dag.h"
+#include "data_structures/dag_jump_table.h"
+#include "data_structures/walking_locator.h"
+#include "drawables/trapezoidvertexupdater.h"
+#include "workloads.h"
+
+/* Half of the side of the bounding box, the same one used by the manager */
+#define BOUNDINGBOX 1e+6
+
+/* Number of query Points used to compute the average query depth */
+#define DEPTH_SAMPLE_SIZE 10000
+
+namespace {
+
+struct Options {
+    std::vector<std::string> workloads;
+    std::vector<size_t> sizes;
+    size_t queries;
+    unsigned int seed;
+    unsigned int threads;
+    double depthFactor;
+    double trajectoryStep;
+    size_t walkBudget;
+    size_t jumpTableResolution;
+    size_t frames;
+    bool json;
+};
+
+struct Result {
+    std::string workload;
+    std::string order;
+    size_t segments;
+    unsigned int seed;
+    size_t buildAttempts;
+    /* Whether the depth bound is met: 1 or 0, -1 when the map is built without a bound */
+    int depthBoundMet;
+    double buildMs;
+    size_t trapezoids;
+    size_t dagNodes;
+    DAG::Statistics dagStatistics;
+    double averageQueryDepth;
+    size_t queries;
+    double queryMs;
+    double batchQueryMs;
+    size_t checksum;
+    double trajectoryQueryMs;
+    double walkQueryMs;
+    WalkingLocator::Statistics walkStatistics;
+    size_t walkMismatches;
+    size_t jumpTableBytes;
+    double jumpTableBuildMs;
+    double averageEntryDepth;
+    double jumpQueryMs;
+    size_t jumpMismatches;
+    size_t compactDAGBytes;
+    double compactDAGBuildMs;
+    double compactQueryMs;
+    size_t compactMismatches;
+    /* Orientation tests of the whole run, only counted when built with ORIENTATION_STATISTICS */
+    size_t frames;
+    double fullFrameMs;
+    double frameUpdateMs;
+    unsigned long long fastOrientationTests;
+    unsigned long long exactOrientationTests;
+};
+
+double fastOrientationRatio(const Result& r) {
+    return double(r.fastOrientationTests) / (r.fastOrientationTests + r.exactOrientationTests);
+}
+
+double elapsedMs(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> values;
+    std::stringstream stream(list);
+    std::string value;
+    while(std::getline(stream, value, ','))
+        if(!value.empty())
+            values.push_back(value);
+    return values;
+}
+
+void printUsage() {
+    std::cerr << "Usage: trapezoidalmap_benchmark [options]\n"
+              << "  --workloads w1,w2,...  workloads to run (default: all):";
+    for(const std::string& name : Workloads::names())
+        std::cerr << " " << name;
+    std::cerr << "\n"
+              << "  --sizes n1,n2,...      numbers of segments (default: 1000,10000,100000)\n"
+              << "  --queries n            number of query points (default: 1000000)\n"
+              << "  --seed s               seed of the workloads and of the construction (default: 0)\n"
+              << "  --threads t            threads of the batch queries, 0 for all the cores (default: 0)\n"
+              << "  --depth-factor c       rebuild the randomized maps deeper than c*log2(n+1) (default: 0, never)\n"
+              << "  --trajectory-step d    length of the steps of the trajectory queries (default: 100)\n"
+              << "  --walk-budget b        maximum number of steps of a walk of the WalkingLocator (default: 16)\n"
+              << "  --jump-table r         cells on each side of the grid of the DAGJumpTable, 0 to skip it (default: 256)\n"
+              << "  --frames k             segments removed and inserted again to time the frames, 0 to skip them (default: 100)\n"
+              << "  --json                 print the results as JSON instead of CSV\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.workloads = Workloads::names();
+    options.sizes = {1000, 10000, 100000};
+    options.queries = 1000000;
+    options.seed = 0;
+    options.threads = 0;
+    options.depthFactor = 0;
+    options.trajectoryStep = 100;
+    options.walkBudget = 16;
+    options.jumpTableResolution = 256;
+    options.frames = 100;
+    options.json = false;
+
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if(arg == "--json") {
+            options.json = true;
+        } else if(arg == "--workloads" && hasValue) {
+            options.workloads = split(argv[++i]);
+            for(const std::string& workload : options.workloads) {
+                if(std::find(Workloads::names().begin(), Workloads::names().end(), workload) == Workloads::names().end()) {
+                    std::cerr << "Unknown workload: " << workload << std::endl;
+                    return false;
+                }
+            }
+        } else if(arg == "--sizes" && hasValue) {
+            options.sizes.clear();
+            for(const std::string& size : split(argv[++i]))
+                options.sizes.push_back(std::strtoull(size.c_str(), nullptr, 10));
+        } else if(arg == "--queries" && hasValue) {
+            options.queries = std::strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if(arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if(arg == "--depth-factor" && hasValue) {
+            options.depthFactor = std::strtod(argv[++i], nullptr);
+        } else if(arg == "--trajectory-step" && hasValue) {
+            options.trajectoryStep = std::strtod(argv[++i], nullptr);
+        } else if(arg == "--walk-budget" && hasValue) {
+            options.walkBudget = std::strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--jump-table" && hasValue) {
+            options.jumpTableResolution = std::strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--frames" && hasValue) {
+            options.frames = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Builds the map of a workload and queries it.
+ *
+ * The x-sorted workload is inserted in its order, the others in the randomized order of buildTrapezoidalMap
+ * (or of buildDepthBoundedTrapezoidalMap, if a depth factor is given).
+ * The queries of a trajectory are answered both by the DAG and by a WalkingLocator,
+ * the uniform queries are answered again through a DAGJumpTable and through a CompactDAG.
+ * At last some Segments are removed and inserted again, bringing the vertex arrays of the viewer
+ * up to date after each change as a frame would.
+ * With ORIENTATION_STATISTICS the orientation tests of all the phases are counted.
+ */
+Result run(const std::string& workload, const size_t& n, const Options& options) {
+    Result result;
+    result.workload = workload;
+    result.segments = n;
+    result.seed = options.seed;
+    result.queries = options.queries;
+
+#ifdef ORIENTATION_STATISTICS
+    Utils::resetOrientationStatistics();
+#endif
+
+    std::vector<cg3::Segment2d> segments = Workloads::generate(workload, n, BOUNDINGBOX, options.seed);
+    std::vector<cg3::Point2d> points = Workloads::queryPoints(options.queries, BOUNDINGBOX, options.seed + 1);
+
+    TrapezoidalMap tm(cg3::Point2d(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, BOUNDINGBOX));
+    DAG dag;
+
+    result.buildAttempts = 1;
+    result.depthBoundMet = -1;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if(workload == "x-sorted") {
+        result.order = "input";
+        dag.addNode(DAGnode(0));
+        Algorithms::InsertionBuffers buffers;
+        for(const cg3::Segment2d& segment : segments)
+            Algorithms::insertSegment(Utils::fixSegmentDirection(segment), dag, tm, buffers);
+    } else if(options.depthFactor > 0) {
+        result.order = "random-bounded";
+        result.depthBoundMet = Algorithms::buildDepthBoundedTrapezoidalMap(segments, options.seed, dag, tm, result.buildAttempts,
+                                                                           options.depthFactor);
+    } else {
+        result.order = "random";
+        Algorithms::buildTrapezoidalMap(segments, options.seed, dag, tm);
+    }
+    result.buildMs = elapsedMs(start);
+
+    result.trapezoids = tm.liveTrapezoidCount();
+    result.dagNodes = dag.getDAGSize();
+    result.dagStatistics = dag.getStatistics();
+
+    std::vector<cg3::Point2d> sample(points.begin(), points.begin() + std::min(points.size(), size_t(DEPTH_SAMPLE_SIZE)));
+    dag.queryDepthHistogram(sample, result.averageQueryDepth);
+
+    /* Single queries on the calling thread */
+    result.checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for(const cg3::Point2d& point : points)
+        result.checksum += dag.findPoint(point, point);
+    result.queryMs = elapsedMs(start);
+
+    /* Batch queries on multiple threads */
+    std::vector<size_t> located;
+    start = std::chrono::steady_clock::now();
+    dag.locate(points, located, options.threads);
+    result.batchQueryMs = elapsedMs(start);
+
+    /* Single queries starting from the entry points of a DAGJumpTable */
+    result.jumpTableBytes = 0;
+    result.jumpTableBuildMs = result.averageEntryDepth = result.jumpQueryMs = 0;
+    result.jumpMismatches = 0;
+    if(options.jumpTableResolution > 0) {
+        start = std::chrono::steady_clock::now();
+        DAGJumpTable jumpTable(dag, tm, options.jumpTableResolution);
+        result.jumpTableBuildMs = elapsedMs(start);
+        result.jumpTableBytes = jumpTable.getMemoryUsage();
+        result.averageEntryDepth = jumpTable.getAverageEntryDepth();
+
+        start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < points.size(); i++)
+            result.jumpMismatches += jumpTable.findPoint(points[i]) != located[i];
+        result.jumpQueryMs = elapsedMs(start);
+    }
+
+    /* Single queries through the CompactDAG compiled from the DAG */
+    start = std::chrono::steady_clock::now();
+    CompactDAG compactDAG(dag);
+    result.compactDAGBuildMs = elapsedMs(start);
+    result.compactDAGBytes = compactDAG.getMemoryUsage();
+
+    result.compactMismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < points.size(); i++)
+        result.compactMismatches += compactDAG.findPoint(points[i], points[i]) != located[i];
+    result.compactQueryMs = elapsedMs(start);
+
+    /* Trajectory queries, through the DAG and walking */
+    std::vector<cg3::Point2d> trajectory = Workloads::trajectoryPoints(options.queries, BOUNDINGBOX, options.trajectoryStep, options.seed + 2);
+
+    located.resize(trajectory.size());
+    start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < trajectory.size(); i++)
+        located[i] = dag.findPoint(trajectory[i], trajectory[i]);
+    result.trajectoryQueryMs = elapsedMs(start);
+
+    WalkingLocator locator(dag, tm, options.walkBudget);
+    result.walkMismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < trajectory.size(); i++)
+        result.walkMismatches += locator.findPoint(trajectory[i]) != located[i];
+    result.walkQueryMs = elapsedMs(start);
+    result.walkStatistics = locator.getStatistics();
+
+    /* Frames of the viewer: all the vertex arrays are written once, then after each change
+     * only the ranges of the changed Trapezoids are written again */
+    result.frames = 0;
+    result.fullFrameMs = result.frameUpdateMs = 0;
+    if(options.frames > 0) {
+        /* The same updater of the DrawableTrapezoidalMap, without any OpenGL context:
+         * only the work done on the CPU for a frame is measured */
+        TrapezoidVertexUpdater updater(tm);
+        tm.setObserver(&updater);
+
+        start = std::chrono::steady_clock::now();
+        updater.updateOutdatedTrapezoids();
+        result.fullFrameMs = elapsedMs(start);
+
+        Algorithms::InsertionBuffers buffers;
+        for(size_t i = 0; i < segments.size() && i < options.frames; i++) {
+            if(!Algorithms::removeSegment(segments[i], dag, tm))
+                continue;
+            start = std::chrono::steady_clock::now();
+            updater.updateOutdatedTrapezoids();
+            result.frameUpdateMs += elapsedMs(start);
+
+            Algorithms::insertSegment(Utils::fixSegmentDirection(segments[i]), dag, tm, buffers);
+            start = std::chrono::steady_clock::now();
+            updater.updateOutdatedTrapezoids();
+            result.frameUpdateMs += elapsedMs(start);
+
+            result.frames += 2;
+        }
+        if(result.frames > 0)
+            result.frameUpdateMs /= result.frames;
+
+        tm.setObserver(nullptr);
+    }
+
+#ifdef ORIENTATION_STATISTICS
+    Utils::getOrientationStatistics(result.fastOrientationTests, result.exactOrientationTests);
+#else
+    result.fastOrientationTests = result.exactOrientationTests = 0;
+#endif
+
+    return result;
+}
+
+double perSecond(const size_t& count, const double& ms) {
+    return ms > 0 ? count / (ms / 1000) : 0;
+}
+
+double averageWalkSteps(const Result& r) {
+    return r.walkStatistics.queries > 0 ? double(r.walkStatistics.steps) / r.walkStatistics.queries : 0;
+}
+
+void printCsvHeader() {
+    std::cout << "workload,order,segments,seed,build_attempts,depth_bound_met,build_ms,trapezoids,dag_nodes,point_nodes,segment_nodes,trapezoid_nodes,"
+              << "shared_leaves,dag_depth,avg_query_depth,"
+              << "queries,query_ms,queries_per_s,batch_query_ms,batch_queries_per_s,checksum,"
+              << "trajectory_query_ms,trajectory_queries_per_s,walk_query_ms,walk_queries_per_s,"
+              << "walk_fallbacks,avg_walk_steps,walk_mismatches,"
+              << "jump_table_bytes,jump_table_build_ms,avg_entry_depth,jump_query_ms,jump_queries_per_s,jump_mismatches,"
+              << "compact_dag_bytes,compact_dag_build_ms,compact_query_ms,compact_queries_per_s,compact_mismatches,"
+              << "frames,full_frame_ms,frame_update_ms,"
+              << "orientation_tests,fast_orientation_ratio" << std::endl;
+}
+
+void printCsv(const Result& r) {
+    std::cout << r.workload << "," << r.order << "," << r.segments << "," << r.seed << ","
+              << r.buildAttempts << "," << (r.depthBoundMet < 0 ? "" : std::to_string(r.depthBoundMet)) << ","
+              << r.buildMs << "," << r.trapezoids << "," << r.dagNodes << ","
+              << r.dagStatistics.pointNodes << "," << r.dagStatistics.segmentNodes << "," << r.dagStatistics.trapezoidNodes << ","
+              << r.dagStatistics.sharedLeaves << "," << r.dagStatistics.maxDepth << "," << r.averageQueryDepth << ","
+              << r.queries << "," << r.queryMs << "," << perSecond(r.queries, r.queryMs) << ","
+              << r.batchQueryMs << "," << perSecond(r.queries, r.batchQueryMs) << "," << r.checksum << ","
+              << r.trajectoryQueryMs << "," << perSecond(r.queries, r.trajectoryQueryMs) << ","
+              << r.walkQueryMs << "," << perSecond(r.queries, r.walkQueryMs) << ","
+              << r.walkStatistics.fallbacks << "," << averageWalkSteps(r) << "," << r.walkMismatches << ","
+              << r.jumpTableBytes << "," << r.jumpTableBuildMs << "," << r.averageEntryDepth << ","
+              << r.jumpQueryMs << "," << perSecond(r.queries, r.jumpQueryMs) << "," << r.jumpMismatches << ","
+              << r.compactDAGBytes << "," << r.compactDAGBuildMs << ","
+              << r.compactQueryMs << "," << perSecond(r.queries, r.compactQueryMs) << "," << r.compactMismatches << ","
+              << r.frames << "," << r.fullFrameMs << "," << r.frameUpdateMs << ",";
+    if(r.fastOrientationTests + r.exactOrientationTests > 0)
+        std::cout << r.fastOrientationTests + r.exactOrientationTests << "," << fastOrientationRatio(r);
+    else
+        std::cout << ",";
+    std::cout << std::endl;
+}
+
+void printJson(const Result& r, const bool& first) {
+    std::cout << (first ? "  " : ",\n  ")
+              << "{\"workload\": \"" << r.workload << "\", \"order\": \"" << r.order << "\""
+              << ", \"segments\": " << r.segments << ", \"seed\": " << r.seed
+              << ", \"build_attempts\": " << r.buildAttempts
+              << ", \"depth_bound_met\": " << (r.depthBoundMet < 0 ? "null" : (r.depthBoundMet ? "true" : "false"))
+              << ", \"build_ms\": " << r.buildMs << ", \"trapezoids\": " << r.trapezoids
+              << ", \"dag_nodes\": " << r.dagNodes << ", \"point_nodes\": " << r.dagStatistics.pointNodes
+              << ", \"segment_nodes\": " << r.dagStatistics.segmentNodes << ", \"trapezoid_nodes\": " << r.dagStatistics.trapezoidNodes
+              << ", \"shared_leaves\": " << r.dagStatistics.sharedLeaves << ", \"dag_depth\": " << r.dagStatistics.maxDepth
+              << ", \"avg_query_depth\": " << r.averageQueryDepth
+              << ", \"queries\": " << r.queries << ", \"query_ms\": " << r.queryMs
+              << ", \"queries_per_s\": " << perSecond(r.queries, r.queryMs)
+              << ", \"batch_query_ms\": " << r.batchQueryMs
+              << ", \"batch_queries_per_s\": " << perSecond(r.queries, r.batchQueryMs)
+              << ", \"checksum\": " << r.checksum
+              << ", \"trajectory_query_ms\": " << r.trajectoryQueryMs
+              << ", \"trajectory_queries_per_s\": " << perSecond(r.queries, r.trajectoryQueryMs)
+              << ", \"walk_query_ms\": " << r.walkQueryMs
+              << ", \"walk_queries_per_s\": " << perSecond(r.queries, r.walkQueryMs)
+              << ", \"walk_fallbacks\": " << r.walkStatistics.fallbacks
+              << ", \"avg_walk_steps\": " << averageWalkSteps(r)
+              << ", \"walk_mismatches\": " << r.walkMismatches
+              << ", \"jump_table_bytes\": " << r.jumpTableBytes
+              << ", \"jump_table_build_ms\": " << r.jumpTableBuildMs
+              << ", \"avg_entry_depth\": " << r.averageEntryDepth
+              << ", \"jump_query_ms\": " << r.jumpQueryMs
+              << ", \"jump_queries_per_s\": " << perSecond(r.queries, r.jumpQueryMs)
+              << ", \"jump_mismatches\": " << r.jumpMismatches
+              << ", \"compact_dag_bytes\": " << r.compactDAGBytes
+              << ", \"compact_dag_build_ms\": " << r.compactDAGBuildMs
+              << ", \"compact_query_ms\": " << r.compactQueryMs
+              << ", \"compact_queries_per_s\": " << perSecond(r.queries, r.compactQueryMs)
+              << ", \"compact_mismatches\": " << r.compactMismatches
+              << ", \"frames\": " << r.frames
+              << ", \"full_frame_ms\": " << r.fullFrameMs
+              << ", \"frame_update_ms\": " << r.frameUpdateMs
+              << ", \"orientation_tests\": ";
+    if(r.fastOrientationTests + r.exactOrientationTests > 0)
+        std::cout << r.fastOrientationTests + r.exactOrientationTests << ", \"fast_orientation_ratio\": " << fastOrientationRatio(r);
+    else
+        std::cout << "null, \"fast_orientation_ratio\": null";
+    std::cout << "}" << std::flush;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    if(options.json)
+        std::cout << "[\n";
+    else
+        printCsvHeader();
+
+    bool first = true;
+    for(const std::string& workload : options.workloads) {
+        for(const size_t& n : options.sizes) {
+            Result result = run(workload, n, options);
+            if(options.json)
+                printJson(result, first);
+            else
+                printCsv(result);
+            first = false;
+        }
+    }
+
+    if(options.json)
+        std::cout << "\n]" << std::endl;
+
+    return 0;
+}
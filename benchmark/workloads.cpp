@@ -0,0 +1,350 @@
+#include "workloads.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_set>
+
+/* Fraction of a cell left empty on each side, so that Segments of different cells never touch */
+#define CELL_MARGIN 0.05
+
+/* Parameters of the clustered workload */
+#define CLUSTERS 8
+#define CLUSTER_SIGMA 0.0625
+#define CLUSTER_GRID_FACTOR 4
+
+/* Standard deviation of the change of direction (in radians) at each step of a trajectory */
+#define TRAJECTORY_TURN_SIGMA 0.2
+
+namespace Workloads {
+
+namespace {
+
+/**
+ * @brief Keeps track of the x coordinates already used by the endpoints of a workload.
+ */
+class XCoordinates {
+    private:
+        std::unordered_set<double> used;
+    public:
+        /**
+         * @brief Reserves the x coordinates of a new Segment.
+         * @return false if the Segment is vertical or one of the coordinates is already used
+         */
+        bool reserve(const double& x1, const double& x2) {
+            if(x1 == x2 || used.count(x1) > 0 || used.count(x2) > 0)
+                return false;
+
+            used.insert(x1);
+            used.insert(x2);
+            return true;
+        }
+};
+
+/**
+ * @brief Generates a random Segment inside a cell, away from its boundaries.
+ * @param x0, y0, bot left corner of the cell
+ * @param width, height, size of the cell
+ * @param rng, the random generator
+ * @param xCoordinates, the x coordinates already used
+ * @return the Segment
+ */
+cg3::Segment2d randomSegmentInCell(const double& x0, const double& y0, const double& width, const double& height,
+                                   std::mt19937& rng, XCoordinates& xCoordinates) {
+    std::uniform_real_distribution<double> xDist(x0 + CELL_MARGIN * width, x0 + (1 - CELL_MARGIN) * width);
+    std::uniform_real_distribution<double> yDist(y0 + CELL_MARGIN * height, y0 + (1 - CELL_MARGIN) * height);
+
+    double x1, x2;
+    do {
+        x1 = xDist(rng);
+        x2 = xDist(rng);
+    } while(!xCoordinates.reserve(x1, x2));
+
+    double y1 = yDist(rng);
+    double y2 = yDist(rng);
+    return cg3::Segment2d(cg3::Point2d(x1, y1), cg3::Point2d(x2, y2));
+}
+
+/**
+ * @brief Number of cells on each side of a square grid having at least n cells.
+ */
+size_t gridSide(const size_t& n) {
+    size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+    return std::max(side, size_t(1));
+}
+
+}
+
+/**
+ * @brief Short Segments with random endpoints, each one inside a different random cell of a grid
+ * covering the whole square.
+ * @param n, the number of Segments
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator
+ * @return the Segments
+ */
+std::vector<cg3::Segment2d> uniform(const size_t& n, const double& radius, const unsigned int& seed) {
+    std::mt19937 rng(seed);
+    XCoordinates xCoordinates;
+
+    size_t side = gridSide(n);
+    double cellSize = 2 * radius / side;
+
+    std::vector<size_t> cells(side * side);
+    for(size_t i = 0; i < cells.size(); i++)
+        cells[i] = i;
+    std::shuffle(cells.begin(), cells.end(), rng);
+
+    std::vector<cg3::Segment2d> segments;
+    segments.reserve(n);
+    for(size_t i = 0; i < n; i++) {
+        double x0 = -radius + (cells[i] % side) * cellSize;
+        double y0 = -radius + (cells[i] / side) * cellSize;
+        segments.push_back(randomSegmentInCell(x0, y0, cellSize, cellSize, rng, xCoordinates));
+    }
+
+    return segments;
+}
+
+/**
+ * @brief The Segments of the uniform workload sorted by their left endpoint,
+ * to be inserted in this order (the worst case of the non randomized construction).
+ * @param n, the number of Segments
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator
+ * @return the Segments
+ */
+std::vector<cg3::Segment2d> xSorted(const size_t& n, const double& radius, const unsigned int& seed) {
+    std::vector<cg3::Segment2d> segments = uniform(n, radius, seed);
+
+    std::sort(segments.begin(), segments.end(), [](const cg3::Segment2d& a, const cg3::Segment2d& b) {
+        return std::min(a.p1().x(), a.p2().x()) < std::min(b.p1().x(), b.p2().x());
+    });
+
+    return segments;
+}
+
+/**
+ * @brief Short Segments inside the cells of a fine grid, chosen around a few random centers
+ * with a normal distribution.
+ * @param n, the number of Segments
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator
+ * @return the Segments
+ */
+std::vector<cg3::Segment2d> clustered(const size_t& n, const double& radius, const unsigned int& seed) {
+    std::mt19937 rng(seed);
+    XCoordinates xCoordinates;
+
+    size_t side = gridSide(n) * CLUSTER_GRID_FACTOR;
+    double cellSize = 2 * radius / side;
+
+    std::uniform_real_distribution<double> centerDist(-radius / 2, radius / 2);
+    std::vector<cg3::Point2d> centers;
+    for(size_t c = 0; c < CLUSTERS; c++) {
+        double x = centerDist(rng);
+        double y = centerDist(rng);
+        centers.push_back(cg3::Point2d(x, y));
+    }
+
+    std::uniform_int_distribution<size_t> clusterDist(0, CLUSTERS - 1);
+    std::normal_distribution<double> offsetDist(0, CLUSTER_SIGMA * radius);
+
+    std::vector<bool> occupied(side * side, false);
+    std::vector<cg3::Segment2d> segments;
+    segments.reserve(n);
+    while(segments.size() < n) {
+        const cg3::Point2d& center = centers[clusterDist(rng)];
+        double x = center.x() + offsetDist(rng);
+        double y = center.y() + offsetDist(rng);
+        if(x <= -radius || x >= radius || y <= -radius || y >= radius)
+            continue;
+
+        size_t column = std::min(static_cast<size_t>((x + radius) / cellSize), side - 1);
+        size_t row = std::min(static_cast<size_t>((y + radius) / cellSize), side - 1);
+        if(occupied[row * side + column])
+            continue;
+        occupied[row * side + column] = true;
+
+        double x0 = -radius + column * cellSize;
+        double y0 = -radius + row * cellSize;
+        segments.push_back(randomSegmentInCell(x0, y0, cellSize, cellSize, rng, xCoordinates));
+    }
+
+    return segments;
+}
+
+/**
+ * @brief Long, almost horizontal Segments stacked on top of each other,
+ * each one crossing most of the square.
+ * @param n, the number of Segments
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator
+ * @return the Segments
+ */
+std::vector<cg3::Segment2d> longSkinny(const size_t& n, const double& radius, const unsigned int& seed) {
+    std::mt19937 rng(seed);
+    XCoordinates xCoordinates;
+
+    double spacing = 2 * radius / std::max(n, size_t(1));
+
+    std::uniform_real_distribution<double> leftDist(-radius * (1 - CELL_MARGIN), -radius / 2);
+    std::uniform_real_distribution<double> rightDist(radius / 2, radius * (1 - CELL_MARGIN));
+    std::uniform_real_distribution<double> yOffsetDist(-spacing / 4, spacing / 4);
+
+    std::vector<cg3::Segment2d> segments;
+    segments.reserve(n);
+    for(size_t i = 0; i < n; i++) {
+        double y = -radius + (i + 0.5) * spacing;
+
+        double x1, x2;
+        do {
+            x1 = leftDist(rng);
+            x2 = rightDist(rng);
+        } while(!xCoordinates.reserve(x1, x2));
+
+        double y1 = y + yOffsetDist(rng);
+        double y2 = y + yOffsetDist(rng);
+        segments.push_back(cg3::Segment2d(cg3::Point2d(x1, y1), cg3::Point2d(x2, y2)));
+    }
+
+    return segments;
+}
+
+/**
+ * @brief Diagonals of the cells of a regular grid, alternating their direction.
+ * The x coordinates are shifted a little on each row, to keep them distinct.
+ * @param n, the number of Segments
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator (it moves the endpoints vertically by a small amount)
+ * @return the Segments
+ */
+std::vector<cg3::Segment2d> grid(const size_t& n, const double& radius, const unsigned int& seed) {
+    std::mt19937 rng(seed);
+
+    size_t side = gridSide(n);
+    double cellSize = 2 * radius / side;
+    double rowShift = CELL_MARGIN * cellSize / (side + 1);
+
+    std::uniform_real_distribution<double> yOffsetDist(-CELL_MARGIN * cellSize, CELL_MARGIN * cellSize);
+
+    std::vector<cg3::Segment2d> segments;
+    segments.reserve(n);
+    for(size_t i = 0; i < n; i++) {
+        size_t column = i % side;
+        size_t row = i / side;
+
+        double x0 = -radius + column * cellSize;
+        double y0 = -radius + row * cellSize;
+        double shift = (row + 1) * rowShift;
+
+        double x1 = x0 + 2 * CELL_MARGIN * cellSize + shift;
+        double x2 = x0 + (1 - 2 * CELL_MARGIN) * cellSize + shift;
+        double yLow = y0 + 3 * CELL_MARGIN * cellSize + yOffsetDist(rng);
+        double yHigh = y0 + (1 - 3 * CELL_MARGIN) * cellSize + yOffsetDist(rng);
+
+        if((row + column) % 2 == 0)
+            segments.push_back(cg3::Segment2d(cg3::Point2d(x1, yLow), cg3::Point2d(x2, yHigh)));
+        else
+            segments.push_back(cg3::Segment2d(cg3::Point2d(x1, yHigh), cg3::Point2d(x2, yLow)));
+    }
+
+    return segments;
+}
+
+/**
+ * @brief Generates a workload given its name.
+ * @param name, one of the names returned by names()
+ * @param n, the number of Segments
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator
+ * @return the Segments, empty if the name is unknown
+ */
+std::vector<cg3::Segment2d> generate(const std::string& name, const size_t& n, const double& radius, const unsigned int& seed) {
+    if(name == "uniform")
+        return uniform(n, radius, seed);
+    if(name == "x-sorted")
+        return xSorted(n, radius, seed);
+    if(name == "clustered")
+        return clustered(n, radius, seed);
+    if(name == "long-skinny")
+        return longSkinny(n, radius, seed);
+    if(name == "grid")
+        return grid(n, radius, seed);
+    return std::vector<cg3::Segment2d>();
+}
+
+/**
+ * @brief Returns the names of the available workloads.
+ * @return the names
+ */
+const std::vector<std::string>& names() {
+    static const std::vector<std::string> workloadNames = {"uniform", "x-sorted", "clustered", "long-skinny", "grid"};
+    return workloadNames;
+}
+
+/**
+ * @brief Generates uniformly distributed query Points inside the square.
+ * @param n, the number of Points
+ * @param radius, half of the side of the square
+ * @param seed, the seed of the random generator
+ * @return the Points
+ */
+std::vector<cg3::Point2d> queryPoints(const size_t& n, const double& radius, const unsigned int& seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-radius, radius);
+
+    std::vector<cg3::Point2d> points;
+    points.reserve(n);
+    for(size_t i = 0; i < n; i++) {
+        double x = dist(rng);
+        double y = dist(rng);
+        points.push_back(cg3::Point2d(x, y));
+    }
+
+    return points;
+}
+
+/**
+ * @brief Generates the query Points of a trajectory (e.g. the mouse or a GPS trace) inside the square.
+ * The trajectory starts at a random Point and makes steps of the same length, its direction changes
+ * a little at every step and it bounces on the sides of the square.
+ * @param n, the number of Points
+ * @param radius, half of the side of the square
+ * @param step, the length of a step
+ * @param seed, the seed of the random generator
+ * @return the Points
+ */
+std::vector<cg3::Point2d> trajectoryPoints(const size_t& n, const double& radius, const double& step, const unsigned int& seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-radius, radius);
+    std::normal_distribution<double> turn(0, TRAJECTORY_TURN_SIGMA);
+
+    double x = dist(rng);
+    double y = dist(rng);
+    double direction = std::uniform_real_distribution<double>(0, 2 * M_PI)(rng);
+
+    std::vector<cg3::Point2d> points;
+    points.reserve(n);
+    for(size_t i = 0; i < n; i++) {
+        points.push_back(cg3::Point2d(x, y));
+
+        direction += turn(rng);
+        x += step * std::cos(direction);
+        y += step * std::sin(direction);
+
+        /* Bounces on the sides */
+        if(x < -radius || x > radius) {
+            x = std::max(-radius, std::min(radius, x));
+            direction = M_PI - direction;
+        }
+        if(y < -radius || y > radius) {
+            y = std::max(-radius, std::min(radius, y));
+            direction = -direction;
+        }
+    }
+
+    return points;
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef WORKLOADS_H
+#define WORKLOADS_H
+
+#include <cg3/geometry/segment2.h>
+#include <cg3/geometry/point2.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Generators of the standard workloads of the benchmark.
+ * Every workload is made of non-intersecting, non-degenerate Segments in general position
+ * (no two endpoints share the same x coordinate) lying inside the square [-radius, radius]^2,
+ * and it only depends on the number of Segments and on the seed.
+ */
+namespace Workloads {
+    std::vector<cg3::Segment2d> uniform(const size_t& n, const double& radius, const unsigned int& seed);
+    std::vector<cg3::Segment2d> xSorted(const size_t& n, const double& radius, const unsigned int& seed);
+    std::vector<cg3::Segment2d> clustered(const size_t& n, const double& radius, const unsigned int& seed);
+    std::vector<cg3::Segment2d> longSkinny(const size_t& n, const double& radius, const unsigned int& seed);
+    std::vector<cg3::Segment2d> grid(const size_t& n, const double& radius, const unsigned int& seed);
+
+    std::vector<cg3::Segment2d> generate(const std::string& name, const size_t& n, const double& radius, const unsigned int& seed);
+    const std::vector<std::string>& names();
+
+    std::vector<cg3::Point2d> queryPoints(const size_t& n, const double& radius, const unsigned int& seed);
+    std::vector<cg3::Point2d> trajectoryPoints(const size_t& n, const double& radius, const double& step, const unsigned int& seed);
+}
+
+#endif // WORKLOADS_H
@@ -0,0 +1,271 @@
+#include "compact_dag.h"
+
+#include <unordered_map>
+
+/* Minimum number of queries assigned to a thread by CompactDAG::locate */
+#define LOCATE_MIN_QUERIES_PER_THREAD 4096
+
+/**
+ * @brief CompactDAG Constructor, builds an empty CompactDAG
+ * locating every Point in the Trapezoid of index 0
+ */
+CompactDAG::CompactDAG() {
+    root = LEAF_FLAG;
+    owner = true;
+    updateTables();
+}
+
+/**
+ * @brief CompactDAG Constructor, "compiles" a built DAG.
+ * Only the DAGnodes reachable from the root are kept, and equal Points
+ * and Segments share the same entry of the side tables.
+ * Both the DAG and the TrapezoidalMap must have less than 2^31 elements.
+ * @param dag, the DAG
+ */
+CompactDAG::CompactDAG(const DAG& dag) {
+    assert(dag.getDAGSize() > 0 && dag.getDAGSize() < LEAF_FLAG);
+
+    owner = true;
+
+    std::unordered_map<double, uint32_t> pointIds;
+    std::unordered_map<cg3::Segment2d, uint32_t> segmentIds;
+
+    /* New index of each DAGnode, UINT32_MAX if not visited yet */
+    std::vector<uint32_t> newIndexes(dag.getDAGSize(), UINT32_MAX);
+
+    /* Returns the encoded reference to a DAGnode, assigning it a position if needed */
+    auto reference = [&](const size_t& index, std::vector<size_t>& stack) -> uint32_t {
+        const DAGnode& node = dag.getNode(index);
+        if(node.isTrapezoidNode()) {
+            /* The index of the Trapezoid must leave the LEAF_FLAG bit free, so the map has less than 2^31 Trapezoids */
+            assert(node.getTrapezoidValue() < LEAF_FLAG);
+            return static_cast<uint32_t>(node.getTrapezoidValue()) | LEAF_FLAG;
+        }
+
+        if(newIndexes[index] == UINT32_MAX) {
+            newIndexes[index] = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node());
+            stack.push_back(index);
+        }
+        return newIndexes[index];
+    };
+
+    /* Depth-first visit: the left child is pushed last so that it is
+     * placed right after its father */
+    std::vector<size_t> stack;
+    root = reference(0, stack);
+
+    while(!stack.empty()) {
+        size_t index = stack.back();
+        stack.pop_back();
+
+        const DAGnode& node = dag.getNode(index);
+        Node compactNode;
+
+        if(node.isPointNode()) {
+            compactNode.type = pointNode;
+
+            double x = dag.getPointValue(node).x();
+            auto it = pointIds.find(x);
+            if(it == pointIds.end()) {
+                it = pointIds.insert(std::make_pair(x, static_cast<uint32_t>(pointXs.size()))).first;
+                pointXs.push_back(x);
+            }
+            compactNode.value = it->second;
+        }
+        else {
+            compactNode.type = segmentNode;
+
+            const cg3::Segment2d& s = dag.getSegmentValue(node);
+            auto it = segmentIds.find(s);
+            if(it == segmentIds.end()) {
+                it = segmentIds.insert(std::make_pair(s, static_cast<uint32_t>(segments.size()))).first;
+                segments.push_back({s.p1().x(), s.p1().y(), s.p2().x(), s.p2().y()});
+            }
+            compactNode.value = it->second;
+        }
+
+        compactNode.right = reference(node.getRight(), stack);
+        compactNode.left = reference(node.getLeft(), stack);
+
+        nodes[newIndexes[index]] = compactNode;
+    }
+
+    updateTables();
+}
+
+/**
+ * @brief CompactDAG Constructor, builds a view over tables stored elsewhere.
+ * The tables are not copied and must outlive the CompactDAG.
+ * @param root, the root (a node index, or a Trapezoid index marked with LEAF_FLAG)
+ * @param nodes, nodeCount, the nodes
+ * @param pointXs, pointXCount, the side table of the "point" nodes
+ * @param segments, segmentCount, the side table of the "segment" nodes
+ */
+CompactDAG::CompactDAG(const uint32_t& root, const Node* nodes, const size_t& nodeCount,
+                       const double* pointXs, const size_t& pointXCount,
+                       const Segment* segments, const size_t& segmentCount) :
+    root(root),
+    nodeData(nodes), nodeCount(nodeCount),
+    pointXData(pointXs), pointXCount(pointXCount),
+    segmentData(segments), segmentCount(segmentCount),
+    owner(false)
+{
+    assert((root & LEAF_FLAG) || root < nodeCount);
+}
+
+/**
+ * @brief CompactDAG Copy Constructor, a copy of a view is a view over the same tables
+ * @param other, the CompactDAG to copy
+ */
+CompactDAG::CompactDAG(const CompactDAG& other) :
+    root(other.root),
+    nodes(other.nodes), pointXs(other.pointXs), segments(other.segments),
+    nodeData(other.nodeData), nodeCount(other.nodeCount),
+    pointXData(other.pointXData), pointXCount(other.pointXCount),
+    segmentData(other.segmentData), segmentCount(other.segmentCount),
+    owner(other.owner)
+{
+    if(owner)
+        updateTables();
+}
+
+/**
+ * @brief CompactDAG Copy Assignment, a copy of a view is a view over the same tables
+ * @param other, the CompactDAG to copy
+ * @return this CompactDAG
+ */
+CompactDAG& CompactDAG::operator=(const CompactDAG& other) {
+    if(this != &other) {
+        CompactDAG copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+/**
+ * @brief Makes the tables used by the queries point to the owned ones
+ */
+void CompactDAG::updateTables() {
+    nodeData = nodes.data();
+    nodeCount = nodes.size();
+    pointXData = pointXs.data();
+    pointXCount = pointXs.size();
+    segmentData = segments.data();
+    segmentCount = segments.size();
+}
+
+/**
+ * @brief Finds the Trapezoid containing a given Point, exactly as DAG::findPoint does
+ * @param point, the Point
+ * @param point2, the second Point used in case the first one overlaps with a Segment endpoint
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid containing the Point.
+ */
+size_t CompactDAG::findPoint(const cg3::Point2d& point, const cg3::Point2d& point2) const {
+    const double px = point.x();
+    const double py = point.y();
+
+    uint32_t current = root;
+
+    while(!(current & LEAF_FLAG)) {
+        const Node& node = nodeData[current];
+
+        bool left;
+        if(node.type == pointNode) {
+            left = px < pointXData[node.value];
+        }
+        else {
+            const Segment& s = segmentData[node.value];
+            if(px != s.x1 || py != s.y1)
+                left = Utils::isPointOnTheLeft(s.x1, s.y1, s.x2, s.y2, px, py);
+            else
+                left = Utils::isPointOnTheLeft(s.x1, s.y1, s.x2, s.y2, point2.x(), point2.y());
+        }
+
+        current = left ? node.left : node.right;
+    }
+
+    return current & ~LEAF_FLAG;
+}
+
+/**
+ * @brief Finds the Trapezoids containing a batch of Points, splitting the work among threads.
+ * @param points, the query Points
+ * @param out, will contain, for each Point, the index of the Trapezoid containing it
+ * @param threads, the number of threads to use (0 to use all the available cores)
+ */
+void CompactDAG::locate(const std::vector<cg3::Point2d>& points, std::vector<size_t>& out,
+                        const unsigned int& threads) const {
+    out.resize(points.size());
+
+    Utils::parallelFor(points.size(), threads, LOCATE_MIN_QUERIES_PER_THREAD,
+                       [this, &points, &out](size_t begin, size_t end) {
+        for(size_t i=begin; i<end; i++)
+            out[i] = findPoint(points[i], points[i]);
+    });
+}
+
+/**
+ * @brief Getter for the root of the CompactDAG
+ * @return the index of the root node, or a Trapezoid index marked with LEAF_FLAG
+ */
+uint32_t CompactDAG::getRoot() const { return root; }
+
+/**
+ * @brief Getter for the nodes of the CompactDAG
+ * @return the array of nodes
+ */
+const CompactDAG::Node* CompactDAG::getNodes() const { return nodeData; }
+
+/**
+ * @brief Getter for the number of nodes of the CompactDAG
+ * @return the number of nodes
+ */
+size_t CompactDAG::getNodeCount() const { return nodeCount; }
+
+/**
+ * @brief Getter for the side table of the "point" nodes
+ * @return the x coordinates of the Points
+ */
+const double* CompactDAG::getPointXs() const { return pointXData; }
+
+/**
+ * @brief Getter for the size of the side table of the "point" nodes
+ * @return the number of x coordinates
+ */
+size_t CompactDAG::getPointXCount() const { return pointXCount; }
+
+/**
+ * @brief Getter for the side table of the "segment" nodes
+ * @return the coordinates of the Segments
+ */
+const CompactDAG::Segment* CompactDAG::getSegments() const { return segmentData; }
+
+/**
+ * @brief Getter for the size of the side table of the "segment" nodes
+ * @return the number of Segments
+ */
+size_t CompactDAG::getSegmentCount() const { return segmentCount; }
+
+/**
+ * @brief Returns the number of bytes used by the nodes and the side tables
+ * @return the memory usage in bytes
+ */
+size_t CompactDAG::getMemoryUsage() const {
+    return nodeCount * sizeof(Node) +
+           pointXCount * sizeof(double) +
+           segmentCount * sizeof(Segment);
+}
+
+/**
+ * @brief Clears the CompactDAG, a view stops referring to its tables.
+ */
+void CompactDAG::clear() {
+    root = LEAF_FLAG;
+    nodes.clear();
+    pointXs.clear();
+    segments.clear();
+
+    owner = true;
+    updateTables();
+}
@@ -0,0 +1,85 @@
+#ifndef COMPACTDAG_H
+#define COMPACTDAG_H
+
+#include <cstdint>
+
+#include "dag.h"
+
+/**
+ * @brief The CompactDAG class.
+ * A read-only copy of a built DAG, laid out for fast point location.
+ * Each internal node is a 16-byte record made of a type tag, the id of its value
+ * inside a side table (x coordinates for the "point" nodes, segment coordinates
+ * for the "segment" nodes) and two 32-bit children.
+ * The "trapezoid" nodes are not stored: a child pointing to a Trapezoid
+ * directly holds its index, marked with the LEAF_FLAG bit.
+ * The nodes are stored in depth-first order starting from the root,
+ * so that a query mostly moves forward in memory.
+ * A CompactDAG can also be a view over tables stored elsewhere (e.g. a memory mapped file),
+ * in that case it does not own them.
+ */
+class CompactDAG {
+    public:
+        static const uint32_t LEAF_FLAG = 0x80000000u;
+
+        struct Node {
+            uint32_t type;
+            uint32_t value;
+            uint32_t left;
+            uint32_t right;
+        };
+
+        struct Segment {
+            double x1, y1;
+            double x2, y2;
+        };
+
+        enum NodeType : uint32_t {pointNode, segmentNode};
+
+        CompactDAG();
+        CompactDAG(const DAG& dag);
+        CompactDAG(const uint32_t& root, const Node* nodes, const size_t& nodeCount,
+                   const double* pointXs, const size_t& pointXCount,
+                   const Segment* segments, const size_t& segmentCount);
+
+        CompactDAG(const CompactDAG& other);
+        CompactDAG(CompactDAG&& other) = default;
+        CompactDAG& operator=(const CompactDAG& other);
+        CompactDAG& operator=(CompactDAG&& other) = default;
+
+        size_t findPoint(const cg3::Point2d& point, const cg3::Point2d& point2) const;
+        void locate(const std::vector<cg3::Point2d>& points, std::vector<size_t>& out,
+                    const unsigned int& threads = 0) const;
+
+        uint32_t getRoot() const;
+        const Node* getNodes() const;
+        size_t getNodeCount() const;
+        const double* getPointXs() const;
+        size_t getPointXCount() const;
+        const Segment* getSegments() const;
+        size_t getSegmentCount() const;
+
+        size_t getMemoryUsage() const;
+
+        void clear();
+    private:
+        uint32_t root;
+
+        /* Tables owned by the CompactDAG, empty if it is a view */
+        std::vector<Node> nodes;
+        std::vector<double> pointXs;
+        std::vector<Segment> segments;
+
+        /* Tables used by the queries */
+        const Node* nodeData;
+        size_t nodeCount;
+        const double* pointXData;
+        size_t pointXCount;
+        const Segment* segmentData;
+        size_t segmentCount;
+        bool owner;
+
+        void updateTables();
+};
+
+#endif // COMPACTDAG_H
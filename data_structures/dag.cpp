@@ -1,15 +1,56 @@
 #include "dag.h"
 
+#ifdef DAG_STATISTICS
+#include <atomic>
+#endif
+
+/* Minimum number of queries assigned to a thread by DAG::locate,
+ * smaller batches are not worth the cost of spawning the threads */
+#define LOCATE_MIN_QUERIES_PER_THREAD 4096
+
+namespace {
+#ifdef DAG_STATISTICS
+    std::atomic<unsigned long long> queryCount(0);
+    std::atomic<unsigned long long> visitedNodeCount(0);
+#endif
+
+    /**
+     * @brief Returns the Point with a given id, an endpoint of one of the Segments (as TrapezoidalMap::getPoint)
+     */
+    inline const cg3::Point2d& pointValue(const std::vector<cg3::Segment2d>& segments, const size_t& id) {
+        return id % 2 == 0 ? segments[id / 2].p1() : segments[id / 2].p2();
+    }
+
+    /**
+     * @brief Returns the child of an inner DAGnode to follow to locate a Point.
+     * @param node, the inner DAGnode
+     * @param segments, the Segments of the TrapezoidalMap
+     * @param point, the Point
+     * @param point2, the Point used when the first one lies on the Segment of the DAGnode
+     * @return the index of the child
+     */
+    inline size_t nextNode(const DAGnode& node, const std::vector<cg3::Segment2d>& segments,
+                           const cg3::Point2d& point, const cg3::Point2d& point2) {
+        if(node.isPointNode())
+            return point.x() < pointValue(segments, node.getPointId()).x() ? node.getLeft() : node.getRight();
+
+        const cg3::Segment2d& segment = segments[node.getSegmentId()];
+        const cg3::Point2d& testedPoint = (point != segment.p1()) ? point : point2;
+
+        return Utils::isPointOnTheLeft(segment, testedPoint) ? node.getLeft() : node.getRight();
+    }
+}
+
 /**
  * @brief DAG Constructor
  */
-DAG::DAG() { }
+DAG::DAG() : segments(nullptr) { }
 
 /**
  * @brief Getter for the root of the DAG
  * @return the DAGnode as root
  */
-const DAGnode& DAG::getRoot() {
+const DAGnode& DAG::getRoot() const {
     assert(nodes.size() > 0);
     return nodes[0];
 }
@@ -19,11 +60,31 @@ const DAGnode& DAG::getRoot() {
  * @param index, index of the needed DAGnode
  * @return the DAGnode in the index
  */
-const DAGnode& DAG::getNode(const size_t& index) {
+const DAGnode& DAG::getNode(const size_t& index) const {
     assert(index >= 0 && index < nodes.size());
     return nodes[index];
 }
 
+/**
+ * @brief Returns the Point of a "point" DAGnode
+ * @param node, the DAGnode
+ * @return the Point
+ */
+const cg3::Point2d& DAG::getPointValue(const DAGnode& node) const {
+    assert(segments != nullptr);
+    return pointValue(*segments, node.getPointId());
+}
+
+/**
+ * @brief Returns the Segment of a "segment" DAGnode
+ * @param node, the DAGnode
+ * @return the Segment
+ */
+const cg3::Segment2d& DAG::getSegmentValue(const DAGnode& node) const {
+    assert(segments != nullptr);
+    return (*segments)[node.getSegmentId()];
+}
+
 /**
  * @brief Updates a DAGnode inside the DAG
  * @param newNode, DAGnode to replace the old with
@@ -32,10 +93,31 @@ const DAGnode& DAG::getNode(const size_t& index) {
  */
 size_t DAG::updateNode(const DAGnode& newNode, const size_t& index) {
     assert(index >= 0 && index < nodes.size());
+    history.save(index, nodes[index]);
     nodes[index] = newNode;
     return index;
 }
 
+/**
+ * @brief Sets the left "child" of a DAGnode
+ * @param index, index of the DAGnode
+ * @param leftNode, index of the new left child
+ */
+void DAG::setLeft(const size_t& index, const size_t& leftNode) {
+    history.save(index, nodes[index]);
+    nodes[index].setLeft(leftNode);
+}
+
+/**
+ * @brief Sets the right "child" of a DAGnode
+ * @param index, index of the DAGnode
+ * @param rightNode, index of the new right child
+ */
+void DAG::setRight(const size_t& index, const size_t& rightNode) {
+    history.save(index, nodes[index]);
+    nodes[index].setRight(rightNode);
+}
+
 /**
  * @brief Adds a DAGnode inside the DAG
  * @param newNode, DAGnode to add
@@ -55,7 +137,7 @@ size_t DAG::addNode(const DAGnode& newNode) {
 size_t DAG::addLeftChild(const DAGnode& newNode, const size_t& index) {
     assert(index >= 0 && index < nodes.size());
     size_t newIndex = addNode(newNode);
-    nodes[index].setLeft(newIndex);
+    setLeft(index, newIndex);
     return newIndex;
 }
 
@@ -68,25 +150,27 @@ size_t DAG::addLeftChild(const DAGnode& newNode, const size_t& index) {
 size_t DAG::addRightChild(const DAGnode& newNode, const size_t& index) {
     assert(index >= 0 && index < nodes.size());
     size_t newIndex = addNode(newNode);
-    nodes[index].setRight(newIndex);
+    setRight(index, newIndex);
     return newIndex;
 }
 
 /**
  * @brief Updates the DAG after a split 4
  * @param tm, the Trapezoidal Map
- * @param s, the segment the split has been performed around
+ * @param segment, the id of the segment the split has been performed around
  * @param nodeToReplace, index of the node in which the pattern gotta be attached to
  * @param trpsz, vecotr of indexes of Trapezoid involved in the split
  */
-void DAG::split4(TrapezoidalMap& tm, const cg3::Segment2d& s,
+void DAG::split4(TrapezoidalMap& tm, const size_t& segment,
                  const size_t& nodeToReplace, const std::array<size_t, 4>& trpzs) {
-    size_t n1 = updateNode(DAGnode(s.p1()), nodeToReplace);
+    segments = &tm.getSegments();
+
+    size_t n1 = updateNode(DAGnode(DAGnode::point, TrapezoidalMap::getLeftPointId(segment)), nodeToReplace);
 
     size_t n2 = addLeftChild(DAGnode(trpzs[0]), n1);
-    size_t n3 = addRightChild(DAGnode(s.p2()), n1);
+    size_t n3 = addRightChild(DAGnode(DAGnode::point, TrapezoidalMap::getRightPointId(segment)), n1);
 
-    size_t n4 = addLeftChild(DAGnode(s), n3);
+    size_t n4 = addLeftChild(DAGnode(DAGnode::segment, segment), n3);
     size_t n5 = addRightChild(DAGnode(trpzs[3]), n3);
 
     size_t n6 = addLeftChild(DAGnode(trpzs[1]), n4);
@@ -101,16 +185,18 @@ void DAG::split4(TrapezoidalMap& tm, const cg3::Segment2d& s,
 /**
  * @brief Updates the DAG after a split 3 on the left side of the segment
  * @param tm, the Trapezoidal Map
- * @param s, the segment the split has been performed around
+ * @param segment, the id of the segment the split has been performed around
  * @param nodeToReplace, index of the node in which the pattern gotta be attached to
  * @param trpsz, vecotr of indexes of Trapezoid involved in the split
  */
-void DAG::split3L(TrapezoidalMap& tm, const cg3::Segment2d& s,
+void DAG::split3L(TrapezoidalMap& tm, const size_t& segment,
                   const size_t& nodeToReplace, const std::array<size_t, 3>& trpzs) {
-    size_t n1 = updateNode(DAGnode(s.p1()), nodeToReplace);
+    segments = &tm.getSegments();
+
+    size_t n1 = updateNode(DAGnode(DAGnode::point, TrapezoidalMap::getLeftPointId(segment)), nodeToReplace);
 
     size_t n2 = addLeftChild(DAGnode(trpzs[0]), n1);
-    size_t n3 = addRightChild(DAGnode(s), n1);
+    size_t n3 = addRightChild(DAGnode(DAGnode::segment, segment), n1);
 
     size_t n4 = addLeftChild(DAGnode(trpzs[1]), n3);
     size_t n5 = addRightChild(DAGnode(trpzs[2]), n3);
@@ -123,15 +209,17 @@ void DAG::split3L(TrapezoidalMap& tm, const cg3::Segment2d& s,
 /**
  * @brief Updates the DAG after a split 3 on the right of the segment
  * @param tm, the Trapezoidal Map
- * @param s, the segment the split has been performed around
+ * @param segment, the id of the segment the split has been performed around
  * @param nodeToReplace, index of the node in which the pattern gotta be attached to
  * @param trpsz, vecotr of indexes of Trapezoid involved in the split
  */
-void DAG::split3R(TrapezoidalMap& tm, const cg3::Segment2d& s,
+void DAG::split3R(TrapezoidalMap& tm, const size_t& segment,
                   const size_t& nodeToReplace, const std::array<size_t, 3>& trpzs) {
-    size_t n1 = updateNode(DAGnode(s.p2()), nodeToReplace);
+    segments = &tm.getSegments();
+
+    size_t n1 = updateNode(DAGnode(DAGnode::point, TrapezoidalMap::getRightPointId(segment)), nodeToReplace);
 
-    size_t n2 = addLeftChild(DAGnode(s), n1);
+    size_t n2 = addLeftChild(DAGnode(DAGnode::segment, segment), n1);
     size_t n3 = addRightChild(DAGnode(trpzs[2]), n1);
 
     size_t n4, n5;
@@ -139,13 +227,13 @@ void DAG::split3R(TrapezoidalMap& tm, const cg3::Segment2d& s,
         n4 = addLeftChild(DAGnode(trpzs[0]), n2);
     else {
         n4 = tm.getTrapezoid(trpzs[0]).getDAGlink();
-        nodes[n2].setLeft(n4);
+        setLeft(n2, n4);
     }
     if(tm.getTrapezoid(trpzs[1]).getDAGlink() == SIZE_MAX)
         n5 = addRightChild(DAGnode(trpzs[1]), n2);
     else {
         n5 = tm.getTrapezoid(trpzs[1]).getDAGlink();
-        nodes[n2].setRight(n5);
+        setRight(n2, n5);
     }
 
     tm.getTrapezoid(trpzs[0]).setDAGlink(n4);
@@ -156,13 +244,15 @@ void DAG::split3R(TrapezoidalMap& tm, const cg3::Segment2d& s,
 /**
  * @brief Updates the DAG after a split 2
  * @param tm, the Trapezoidal Map
- * @param s, the segment the split has been performed around
+ * @param segment, the id of the segment the split has been performed around
  * @param nodeToReplace, index of the node in which the pattern gotta be attached to
  * @param trpsz, vecotr of indexes of Trapezoid involved in the split
  */
-void DAG::split2(TrapezoidalMap& tm, const cg3::Segment2d& s,
+void DAG::split2(TrapezoidalMap& tm, const size_t& segment,
                  const size_t& nodeToReplace, const std::array<size_t, 2>& trpzs) {
-    size_t n1 = updateNode(DAGnode(s), nodeToReplace);
+    segments = &tm.getSegments();
+
+    size_t n1 = updateNode(DAGnode(DAGnode::segment, segment), nodeToReplace);
 
     size_t n2 = tm.getTrapezoid(trpzs[0]).getDAGlink();
     size_t n3 = tm.getTrapezoid(trpzs[1]).getDAGlink();
@@ -170,57 +260,386 @@ void DAG::split2(TrapezoidalMap& tm, const cg3::Segment2d& s,
         n2 = addLeftChild(DAGnode(trpzs[0]), n1);
     else {
         n2 = tm.getTrapezoid(trpzs[0]).getDAGlink();
-        nodes[n1].setLeft(n2);
+        setLeft(n1, n2);
     }
     if(tm.getTrapezoid(trpzs[1]).getDAGlink() == SIZE_MAX)
         n3 = addRightChild(DAGnode(trpzs[1]), n1);
     else {
         n3 = tm.getTrapezoid(trpzs[1]).getDAGlink();
-        nodes[n1].setRight(n3);
+        setRight(n1, n3);
     }
 
     tm.getTrapezoid(trpzs[0]).setDAGlink(n2);
     tm.getTrapezoid(trpzs[1]).setDAGlink(n3);
 }
 
+/**
+ * @brief Updates the DAG replacing a node with a balanced pattern of "point" nodes,
+ * used to locate a Point among Trapezoids lying side by side.
+ *
+ * The Trapezoids without a DAGnode get a new leaf, the others keep their own.
+ * If there is a single Trapezoid without a DAGnode, the replaced node becomes its leaf.
+ * @param tm, the Trapezoidal Map
+ * @param nodeToReplace, index of the node in which the pattern gotta be attached to
+ * @param points, the ids of the Points separating the Trapezoids (one less than the Trapezoids)
+ * @param trpzs, vector of indexes of the Trapezoids, from left to right
+ */
+void DAG::splitX(TrapezoidalMap& tm, const size_t& nodeToReplace,
+                 const std::vector<size_t>& points, const std::vector<size_t>& trpzs) {
+    assert(trpzs.size() > 0 && points.size() == trpzs.size()-1);
+
+    segments = &tm.getSegments();
+
+    if(trpzs.size() == 1 && tm.getTrapezoid(trpzs[0]).getDAGlink() == SIZE_MAX) {
+        updateNode(DAGnode(trpzs[0]), nodeToReplace);
+        tm.getTrapezoid(trpzs[0]).setDAGlink(nodeToReplace);
+        return;
+    }
+
+    std::vector<size_t> leaves;
+    leaves.reserve(trpzs.size());
+    for(const size_t& trpz : trpzs) {
+        if(tm.getTrapezoid(trpz).getDAGlink() == SIZE_MAX)
+            tm.getTrapezoid(trpz).setDAGlink(addNode(DAGnode(trpz)));
+        leaves.push_back(tm.getTrapezoid(trpz).getDAGlink());
+    }
+
+    /* A single Trapezoid which already has a leaf: the replaced node just leads to it */
+    if(trpzs.size() == 1) {
+        updateNode(DAGnode(DAGnode::point, tm.getTrapezoid(trpzs[0]).getLeftPId(), leaves[0], leaves[0]), nodeToReplace);
+        return;
+    }
+
+    size_t mid = trpzs.size() / 2;
+    size_t l = buildXSubDAG(points, leaves, 0, mid-1);
+    size_t r = buildXSubDAG(points, leaves, mid, trpzs.size()-1);
+    updateNode(DAGnode(DAGnode::point, points[mid-1], l, r), nodeToReplace);
+}
+
+/**
+ * @brief Builds a balanced sub-DAG of "point" nodes over a range of leaves
+ * @param points, the ids of the Points separating the leaves
+ * @param leaves, the leaves, from left to right
+ * @param first, index of the first leaf of the range
+ * @param last, index of the last leaf of the range
+ * @return the index of the root of the sub-DAG
+ */
+size_t DAG::buildXSubDAG(const std::vector<size_t>& points, const std::vector<size_t>& leaves,
+                         const size_t& first, const size_t& last) {
+    if(first == last)
+        return leaves[first];
+
+    size_t mid = (first + last + 1) / 2;
+    size_t l = buildXSubDAG(points, leaves, first, mid-1);
+    size_t r = buildXSubDAG(points, leaves, mid, last);
+    return addNode(DAGnode(DAGnode::point, points[mid-1], l, r));
+}
+
 /**
  * @brief Finds the Trapezoid containing a given Point
  * @param point, the Point
- * @param dag, the DAG
  * @param point2, the second Point used in case the first one overlaps with one already used
  * @return returns the index (inside the TrapezoidalMap) of the Trapezoid containing the Point.
  */
-size_t DAG::findPoint(const cg3::Point2d& point, const cg3::Point2d& point2) {
-    DAGnode currentNode = getRoot();
+size_t DAG::findPoint(const cg3::Point2d& point, const cg3::Point2d& point2) const {
+    return findPointFrom(0, point, point2);
+}
+
+/**
+ * @brief Finds the Trapezoid containing a given Point starting from an inner DAGnode instead of the root
+ * (e.g. the entry point of a DAGJumpTable)
+ * @param node, the index of the first DAGnode, every Point of its region has to reach it from the root
+ * @param point, the Point
+ * @param point2, the second Point used in case the first one overlaps with one already used
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid containing the Point.
+ */
+size_t DAG::findPointFrom(const size_t& node, const cg3::Point2d& point, const cg3::Point2d& point2) const {
+    assert(node < nodes.size());
+
+    /* The DAG is only read: the nodes are visited by reference */
+    const DAGnode* currentNode = &nodes[node];
+
+#ifdef DAG_STATISTICS
+    unsigned long long visitedNodes = 0;
+#endif
+    while(!currentNode->isTrapezoidNode()) {
+        currentNode = &nodes[nextNode(*currentNode, *segments, point, point2)];
+#ifdef DAG_STATISTICS
+        visitedNodes++;
+#endif
+    }
+
+#ifdef DAG_STATISTICS
+    queryCount.fetch_add(1, std::memory_order_relaxed);
+    visitedNodeCount.fetch_add(visitedNodes, std::memory_order_relaxed);
+#endif
+    return currentNode->getTrapezoidValue();
+}
+
+/**
+ * @brief Finds the Trapezoid containing a given Point at a committed version of the DAG (in persistent mode)
+ * @param point, the Point
+ * @param point2, the second Point used in case the first one overlaps with one already used
+ * @param version, the version, at most the last committed one
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid containing the Point at that version,
+ * TrapezoidalMap::getTrapezoid returns it as it was at the same version.
+ */
+size_t DAG::findPoint(const cg3::Point2d& point, const cg3::Point2d& point2, const size_t& version) const {
+    assert(nodes.size() > 0);
+
+    const DAGnode* currentNode = &history.get(nodes, 0, version);
+    while(!currentNode->isTrapezoidNode())
+        currentNode = &history.get(nodes, nextNode(*currentNode, *segments, point, point2), version);
+
+    return currentNode->getTrapezoidValue();
+}
+
+/**
+ * @brief Finds the Trapezoid lying right above (or below) the left endpoint of a Segment already inside the map.
+ * @param segment, the Segment (from left to right)
+ * @param above, true to find the Trapezoid above the Segment, false for the one below
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid.
+ */
+size_t DAG::findSegmentTrapezoid(const cg3::Segment2d& segment, const bool& above) const {
+    return findSegmentTrapezoid(segment, segment.p1(), above);
+}
+
+/**
+ * @brief Finds the Trapezoid lying right above (or below) a Point of a Segment already inside the map.
+ * @param segment, the Segment (from left to right)
+ * @param point, the Point, on the Segment (or close enough that no other Segment passes between them)
+ * @param above, true to find the Trapezoid above the Segment, false for the one below
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid.
+ */
+size_t DAG::findSegmentTrapezoid(const cg3::Segment2d& segment, const cg3::Point2d& point, const bool& above) const {
+    assert(nodes.size() > 0);
+
+    const DAGnode* currentNode = &nodes[0];
+
+    while(!currentNode->isTrapezoidNode()) {
+        bool left;
+        if(currentNode->isPointNode()) {
+            left = point.x() < getPointValue(*currentNode).x();
+        }
+        else {
+            const cg3::Segment2d& nodeSegment = getSegmentValue(*currentNode);
 
-    while(!currentNode.isTrapezoidNode()) {
-        if(currentNode.isPointNode()) {
-            if(point.x() < currentNode.getPointValue().x())
-                currentNode = getNode(currentNode.getLeft());
+            if(nodeSegment == segment)
+                left = above;
+            else if(point != nodeSegment.p1())
+                left = Utils::isPointOnTheLeft(nodeSegment, point);
             else
-                currentNode = getNode(currentNode.getRight());
+                left = Utils::isPointOnTheLeft(nodeSegment, segment.p2());
+        }
+
+        currentNode = left ? &nodes[currentNode->getLeft()] : &nodes[currentNode->getRight()];
+    }
+
+    return currentNode->getTrapezoidValue();
+}
+
+/**
+ * @brief Finds the Trapezoids containing a batch of Points.
+ *
+ * The queries are split in contiguous chunks, each one answered by a different thread.
+ * The DAG is never modified, so it must not be updated while the queries are running.
+ * @param points, the query Points
+ * @param out, will contain, for each Point, the index of the Trapezoid containing it
+ * @param threads, the number of threads to use (0 to use all the available cores)
+ */
+void DAG::locate(const std::vector<cg3::Point2d>& points, std::vector<size_t>& out,
+                 const unsigned int& threads) const {
+    out.resize(points.size());
+
+    Utils::parallelFor(points.size(), threads, LOCATE_MIN_QUERIES_PER_THREAD,
+                       [this, &points, &out](size_t begin, size_t end) {
+        for(size_t i=begin; i<end; i++)
+            out[i] = findPoint(points[i], points[i]);
+    });
+}
+
+/**
+ * @brief Returns the number of DAGnodes inside the DAG.
+ * @return the number of DAGnodes
+ */
+size_t DAG::getDAGSize() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Computes the shape of the DAG: the number of DAGnodes of each type, the number of shared leaves
+ * and the maximum depth.
+ *
+ * The DAG is visited once, without recursion.
+ * @return the Statistics
+ */
+DAG::Statistics DAG::getStatistics() const {
+    Statistics statistics = {0, 0, 0, 0, 0};
+    if(nodes.empty())
+        return statistics;
+
+    /* Depth of the subDAG of each visited DAGnode and number of parents of each reached DAGnode */
+    std::vector<size_t> depths(nodes.size(), SIZE_MAX);
+    std::vector<size_t> parents(nodes.size(), 0);
+    std::vector<size_t> stack(1, 0);
+
+    while(!stack.empty()) {
+        size_t index = stack.back();
+        const DAGnode& node = nodes[index];
+
+        if(depths[index] != SIZE_MAX) {
+            stack.pop_back();
+            continue;
         }
-        if(currentNode.isSegmentNode()) {
-            if(point != currentNode.getSegmentValue().p1()) {
-                if(Utils::isPointOnTheLeft(currentNode.getSegmentValue(), point))
-                    currentNode = getNode(currentNode.getLeft());
-                else
-                    currentNode = getNode(currentNode.getRight());
-            } else {
-                if(Utils::isPointOnTheLeft(currentNode.getSegmentValue(), point2))
-                    currentNode = getNode(currentNode.getLeft());
-                else
-                    currentNode = getNode(currentNode.getRight());
-            }
+
+        if(node.isTrapezoidNode()) {
+            depths[index] = 0;
+            statistics.trapezoidNodes++;
+            stack.pop_back();
+            continue;
         }
+
+        size_t left = depths[node.getLeft()];
+        size_t right = depths[node.getRight()];
+        if(left == SIZE_MAX)
+            stack.push_back(node.getLeft());
+        if(right == SIZE_MAX)
+            stack.push_back(node.getRight());
+
+        /* Both children have been visited */
+        if(left != SIZE_MAX && right != SIZE_MAX) {
+            depths[index] = std::max(left, right) + 1;
+            parents[node.getLeft()]++;
+            parents[node.getRight()]++;
+
+            if(node.isPointNode())
+                statistics.pointNodes++;
+            else
+                statistics.segmentNodes++;
+            stack.pop_back();
+        }
+    }
+
+    for(size_t i = 0; i < nodes.size(); i++)
+        if(nodes[i].isTrapezoidNode() && parents[i] > 1)
+            statistics.sharedLeaves++;
+
+    statistics.maxDepth = depths[0];
+    return statistics;
+}
+
+/**
+ * @brief Counts the inner DAGnodes visited to locate a Point, as DAG::findPoint does.
+ * @param point, the Point
+ * @param point2, the Point used when the first one lies on a Segment of the DAG
+ * @return the number of visited inner DAGnodes
+ */
+size_t DAG::findPointDepth(const cg3::Point2d& point, const cg3::Point2d& point2) const {
+    assert(nodes.size() > 0);
+
+    size_t depth = 0;
+    const DAGnode* currentNode = &nodes[0];
+    while(!currentNode->isTrapezoidNode()) {
+        currentNode = &nodes[nextNode(*currentNode, *segments, point, point2)];
+        depth++;
+    }
+
+    return depth;
+}
+
+/**
+ * @brief Computes how many inner DAGnodes are visited to locate each Point of a sample.
+ * @param points, the sample of query Points
+ * @param averageDepth, will contain the average number of visited inner DAGnodes
+ * @return the histogram: its i-th element is the number of queries visiting i inner DAGnodes
+ */
+std::vector<size_t> DAG::queryDepthHistogram(const std::vector<cg3::Point2d>& points, double& averageDepth) const {
+    std::vector<size_t> histogram;
+    size_t totalDepth = 0;
+
+    for(const cg3::Point2d& point : points) {
+        size_t depth = findPointDepth(point, point);
+        if(depth >= histogram.size())
+            histogram.resize(depth+1, 0);
+        histogram[depth]++;
+        totalDepth += depth;
     }
 
-    return currentNode.getTrapezoidValue();
+    averageDepth = points.empty() ? 0 : static_cast<double>(totalDepth) / points.size();
+    return histogram;
+}
+
+#ifdef DAG_STATISTICS
+/**
+ * @brief Returns how many queries have been answered by DAG::findPoint (by any DAG)
+ * and how many inner DAGnodes they have visited
+ * @param queries, the number of queries
+ * @param visitedNodes, the total number of visited inner DAGnodes
+ */
+void DAG::getQueryStatistics(unsigned long long& queries, unsigned long long& visitedNodes) {
+    queries = queryCount.load();
+    visitedNodes = visitedNodeCount.load();
+}
+
+/**
+ * @brief Resets the counters of the queries
+ */
+void DAG::resetQueryStatistics() {
+    queryCount.store(0);
+    visitedNodeCount.store(0);
+}
+#endif
+
+/**
+ * @brief Enables or disables the persistent mode.
+ *
+ * In persistent mode every overwritten DAGnode is kept, so that the Points can be located
+ * as they were at each committed version (at the cost of O(1) space per change).
+ * Enabling it, the current DAG becomes the version 0; disabling it, the previous versions are dropped.
+ * @param persistent, true to enable the persistent mode
+ */
+void DAG::setPersistent(const bool& persistent) {
+    history.setEnabled(persistent);
+}
+
+/**
+ * @brief Tells if the DAG is in persistent mode.
+ * @return true if the previous versions are kept
+ */
+bool DAG::isPersistent() const {
+    return history.isEnabled();
+}
+
+/**
+ * @brief Returns the number of committed versions of the DAG (in persistent mode).
+ * @return the last committed version
+ */
+size_t DAG::getVersion() const {
+    return history.getVersion();
+}
+
+/**
+ * @brief Commits the changes made since the last commit as a new version (in persistent mode).
+ * @return the new version
+ */
+size_t DAG::commitVersion() {
+    return history.commit(nodes.size());
+}
+
+/**
+ * @brief Reserves space for a given number of DAGnodes,
+ * to avoid reallocations of the vector while the DAG is being built.
+ * @param size, the number of DAGnodes to reserve space for
+ */
+void DAG::reserve(const size_t& size) {
+    nodes.reserve(size);
 }
 
 /**
  * @brief Clears the DAG.
+ * In persistent mode, the previous versions are dropped and the empty DAG becomes the version 0.
  */
 void DAG::clear() {
     nodes.clear();
+    history.clear();
 }
@@ -4,19 +4,52 @@
 #import "dagnode.h"
 #import "trapezoidalmap.h"
 #import "utils/utils.h"
+#import "version_history.h"
+
+/* Define DAG_STATISTICS to count the queries answered by DAG::findPoint
+   and the DAGnodes they visit */
 
 /**
  * @brief The DAG class.
  * A DAG is defined through a vector of DAGnodes.
+ * The "point" and "segment" DAGnodes refer to the Segments of the TrapezoidalMap the DAG is built with
+ * (the one given to the split methods), which has to outlive it.
+ * In persistent mode the overwritten DAGnodes are kept, so that the Points can be located
+ * in every committed version of the DAG.
  */
 class DAG {
+    public:
+        /* Shape of the DAG, only the DAGnodes reachable from the root are counted */
+        struct Statistics {
+            size_t pointNodes;
+            size_t segmentNodes;
+            size_t trapezoidNodes;
+            /* Leaves with more than one parent */
+            size_t sharedLeaves;
+            /* Number of inner DAGnodes on the longest path from the root to a leaf */
+            size_t maxDepth;
+        };
     private:
         std::vector<DAGnode> nodes;
+
+        /* Segments of the TrapezoidalMap, read by the queries */
+        const std::vector<cg3::Segment2d>* segments;
+
+        /* Previous DAGnodes in persistent mode */
+        VersionHistory<DAGnode> history;
+
+        void setLeft(const size_t& index, const size_t& leftNode);
+        void setRight(const size_t& index, const size_t& rightNode);
+
+        size_t buildXSubDAG(const std::vector<size_t>& points, const std::vector<size_t>& leaves,
+                            const size_t& first, const size_t& last);
     public:
         DAG();
 
-        const DAGnode& getRoot();
-        const DAGnode& getNode(const size_t& index);
+        const DAGnode& getRoot() const;
+        const DAGnode& getNode(const size_t& index) const;
+        const cg3::Point2d& getPointValue(const DAGnode& node) const;
+        const cg3::Segment2d& getSegmentValue(const DAGnode& node) const;
 
         size_t updateNode(const DAGnode& newNode, const size_t& index);
 
@@ -24,17 +57,40 @@ class DAG {
         size_t addLeftChild(const DAGnode& newNode, const size_t& index);
         size_t addRightChild(const DAGnode& newNode, const size_t& index);
 
-        void split4(TrapezoidalMap& tm, const cg3::Segment2d& s,
+        void split4(TrapezoidalMap& tm, const size_t& segment,
                     const size_t& nodeToReplace, const std::array<size_t, 4>& trpzs);
-        void split3L(TrapezoidalMap& tm, const cg3::Segment2d& s,
+        void split3L(TrapezoidalMap& tm, const size_t& segment,
                      const size_t& nodeToReplace, const std::array<size_t, 3>& trpzs);
-        void split3R(TrapezoidalMap& tm, const cg3::Segment2d& s,
+        void split3R(TrapezoidalMap& tm, const size_t& segment,
                      const size_t& nodeToReplace, const std::array<size_t, 3>& trpzs);
-        void split2(TrapezoidalMap& tm, const cg3::Segment2d& s,
+        void split2(TrapezoidalMap& tm, const size_t& segment,
                     const size_t& nodeToReplace, const std::array<size_t, 2>& trpzs);
+        void splitX(TrapezoidalMap& tm, const size_t& nodeToReplace,
+                    const std::vector<size_t>& points, const std::vector<size_t>& trpzs);
+
+        size_t findPoint(const cg3::Point2d& point, const cg3::Point2d& point2) const;
+        size_t findPointFrom(const size_t& node, const cg3::Point2d& point, const cg3::Point2d& point2) const;
+        size_t findPoint(const cg3::Point2d& point, const cg3::Point2d& point2, const size_t& version) const;
+        size_t findSegmentTrapezoid(const cg3::Segment2d& segment, const bool& above) const;
+        size_t findSegmentTrapezoid(const cg3::Segment2d& segment, const cg3::Point2d& point, const bool& above) const;
+        void locate(const std::vector<cg3::Point2d>& points, std::vector<size_t>& out,
+                    const unsigned int& threads = 0) const;
+
+        size_t getDAGSize() const;
+        Statistics getStatistics() const;
+        size_t findPointDepth(const cg3::Point2d& point, const cg3::Point2d& point2) const;
+        std::vector<size_t> queryDepthHistogram(const std::vector<cg3::Point2d>& points, double& averageDepth) const;
+#ifdef DAG_STATISTICS
+        static void getQueryStatistics(unsigned long long& queries, unsigned long long& visitedNodes);
+        static void resetQueryStatistics();
+#endif
 
-        size_t findPoint(const cg3::Point2d& point, const cg3::Point2d& point2);
+        void setPersistent(const bool& persistent);
+        bool isPersistent() const;
+        size_t getVersion() const;
+        size_t commitVersion();
 
+        void reserve(const size_t& size);
         void clear();
 };
 
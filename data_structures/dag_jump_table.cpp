@@ -0,0 +1,193 @@
+#include "dag_jump_table.h"
+
+#include <algorithm>
+
+#include "utils/utils.h"
+
+/* Fraction of a cell added on each side of it when looking for its entry DAGnode,
+   so that the Points assigned to the cell by a rounded division are still inside it */
+#define CELL_MARGIN 1e-6
+
+/**
+ * @brief DAGJumpTable Constructor, builds the table of a built map
+ * @param dag, the DAG of the map
+ * @param tm, the TrapezoidalMap, whose bounding box is covered by the grid
+ * @param resolution, the number of cells on each side of the bounding box,
+ * the table takes resolution^2 indexes
+ */
+DAGJumpTable::DAGJumpTable(const DAG& dag, const TrapezoidalMap& tm, const size_t& resolution) :
+    dag(dag), resolution(std::max(resolution, size_t(1)))
+{
+    const Trapezoid& boundingBox = tm.getBoundingBox();
+    minX = tm.getLeftP(boundingBox).x();
+    minY = tm.getBot(boundingBox).p1().y();
+    cellWidth = (tm.getRightP(boundingBox).x() - minX) / this->resolution;
+    cellHeight = (tm.getTop(boundingBox).p1().y() - minY) / this->resolution;
+
+    build();
+}
+
+/**
+ * @brief Finds again the entry DAGnode of every cell, it has to be called after a removal or a compaction
+ */
+void DAGJumpTable::build() {
+    entries.resize(resolution * resolution);
+
+    totalEntryDepth = 0;
+    buildCells(0, resolution, 0, resolution, 0, 0);
+    averageEntryDepth = double(totalEntryDepth) / entries.size();
+}
+
+/**
+ * @brief Finds the Trapezoid containing a given Point, starting from the entry DAGnode of its cell
+ * @param point, the Point
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid containing the Point,
+ * the same one returned by DAG::findPoint(point, point)
+ */
+size_t DAGJumpTable::findPoint(const cg3::Point2d& point) const {
+    return dag.findPointFrom(getEntryNode(point), point, point);
+}
+
+/**
+ * @brief Returns the DAGnode a query of a given Point can start from
+ * @param point, the Point
+ * @return the index of the entry DAGnode of its cell, 0 (the root) if the Point is outside of the bounding box
+ */
+size_t DAGJumpTable::getEntryNode(const cg3::Point2d& point) const {
+    size_t index = cell(point);
+    return index == SIZE_MAX ? 0 : fromStoredIndex(entries[index]);
+}
+
+/**
+ * @brief Getter for the number of cells on each side of the bounding box
+ * @return the resolution of the grid
+ */
+size_t DAGJumpTable::getResolution() const {
+    return resolution;
+}
+
+/**
+ * @brief Returns the memory taken by the table
+ * @return the size of the table in bytes
+ */
+size_t DAGJumpTable::getMemoryUsage() const {
+    return sizeof(DAGJumpTable) + entries.capacity() * sizeof(StoredIndex);
+}
+
+/**
+ * @brief Returns the average number of inner DAGnodes skipped by a query, computed over the cells
+ * @return the average depth of the entry DAGnodes
+ */
+double DAGJumpTable::getAverageEntryDepth() const {
+    return averageEntryDepth;
+}
+
+/**
+ * @brief Returns the cell containing a Point
+ * @param point, the Point
+ * @return the index of the cell, SIZE_MAX if the Point is outside of the grid
+ */
+size_t DAGJumpTable::cell(const cg3::Point2d& point) const {
+    double column = (point.x() - minX) / cellWidth;
+    double row = (point.y() - minY) / cellHeight;
+
+    /* Written to be false for NaN too */
+    if(!(column >= 0 && column < resolution && row >= 0 && row < resolution))
+        return SIZE_MAX;
+
+    return static_cast<size_t>(row) * resolution + static_cast<size_t>(column);
+}
+
+/**
+ * @brief Finds the entry DAGnodes of a block of cells.
+ * The DAG is descended once for the whole block, then the block is split in four
+ * and each part goes on from the DAGnode reached, so the top levels are visited once.
+ * @param column1, column2, the range [column1, column2) of columns of the block
+ * @param row1, row2, the range [row1, row2) of rows of the block
+ * @param node, a DAGnode reached by all the Points of the block
+ * @param depth, the depth of that DAGnode
+ */
+void DAGJumpTable::buildCells(const size_t& column1, const size_t& column2, const size_t& row1, const size_t& row2,
+                              const size_t& node, const size_t& depth) {
+    double marginX = cellWidth * CELL_MARGIN;
+    double marginY = cellHeight * CELL_MARGIN;
+
+    size_t blockDepth = depth;
+    size_t blockNode = findEntryNode(node, minX + column1 * cellWidth - marginX, minY + row1 * cellHeight - marginY,
+                                     minX + column2 * cellWidth + marginX, minY + row2 * cellHeight + marginY, blockDepth);
+
+    if(column2 - column1 == 1 && row2 - row1 == 1) {
+        entries[row1 * resolution + column1] = toStoredIndex(blockNode);
+        totalEntryDepth += blockDepth;
+        return;
+    }
+
+    if(dag.getNode(blockNode).isTrapezoidNode()) {
+        for(size_t row = row1; row < row2; row++)
+            for(size_t column = column1; column < column2; column++)
+                entries[row * resolution + column] = toStoredIndex(blockNode);
+        totalEntryDepth += blockDepth * (column2 - column1) * (row2 - row1);
+        return;
+    }
+
+    size_t columnMid = column1 + std::max((column2 - column1) / 2, size_t(1));
+    size_t rowMid = row1 + std::max((row2 - row1) / 2, size_t(1));
+    buildCells(column1, columnMid, row1, rowMid, blockNode, blockDepth);
+    if(columnMid < column2)
+        buildCells(columnMid, column2, row1, rowMid, blockNode, blockDepth);
+    if(rowMid < row2)
+        buildCells(column1, columnMid, rowMid, row2, blockNode, blockDepth);
+    if(columnMid < column2 && rowMid < row2)
+        buildCells(columnMid, column2, rowMid, row2, blockNode, blockDepth);
+}
+
+/**
+ * @brief Descends the DAG while all the Points of a rectangle take the same way.
+ *
+ * A "point" DAGnode is passed when the rectangle is entirely on one side of its vertical line,
+ * a "segment" DAGnode when the four corners are on the same side of the line of its Segment
+ * (the test is linear, so all the Points of the rectangle are on that side too).
+ * @param start, the first DAGnode, reached by all the Points of the rectangle
+ * @param x1, y1, the bottom left corner of the rectangle
+ * @param x2, y2, the top right corner of the rectangle
+ * @param depth, the depth of the first DAGnode, increased by the number of inner DAGnodes passed
+ * @return the index of the deepest DAGnode reached by all the Points of the rectangle
+ */
+size_t DAGJumpTable::findEntryNode(const size_t& start, const double& x1, const double& y1, const double& x2, const double& y2,
+                                   size_t& depth) const {
+    size_t current = start;
+
+    for(; ; depth++) {
+        const DAGnode& node = dag.getNode(current);
+
+        if(node.isTrapezoidNode())
+            return current;
+
+        if(node.isPointNode()) {
+            double x = dag.getPointValue(node).x();
+            if(x2 < x)
+                current = node.getLeft();
+            else if(x1 >= x)
+                current = node.getRight();
+            else
+                return current;
+        }
+        else {
+            /* DAG::findPoint goes left when the orientation is not negative */
+            const cg3::Segment2d& s = dag.getSegmentValue(node);
+            const double corners[4][2] = {{x1, y1}, {x2, y1}, {x1, y2}, {x2, y2}};
+
+            size_t leftCorners = 0;
+            for(size_t i = 0; i < 4; i++)
+                leftCorners += Utils::isPointOnTheLeft(s.p1().x(), s.p1().y(), s.p2().x(), s.p2().y(),
+                                                       corners[i][0], corners[i][1]);
+
+            if(leftCorners == 4)
+                current = node.getLeft();
+            else if(leftCorners == 0)
+                current = node.getRight();
+            else
+                return current;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef DAG_JUMP_TABLE_H
+#define DAG_JUMP_TABLE_H
+
+#include "dag.h"
+
+/**
+ * @brief The DAGJumpTable class.
+ * A uniform grid laid over the bounding box of a built map, mapping each cell to the deepest DAGnode
+ * reached by every Point of the cell: a query starts from the DAGnode of its cell and skips
+ * the top levels of the DAG, which are the same for all the Points of a region.
+ * The Points outside of the bounding box start from the root.
+ *
+ * The table stays correct while Segments are inserted, since a DAGnode is only replaced by the DAGnodes
+ * splitting its own region, but it has to be built again after a removal or a compaction.
+ */
+class DAGJumpTable {
+    public:
+        DAGJumpTable(const DAG& dag, const TrapezoidalMap& tm, const size_t& resolution = 256);
+
+        void build();
+        size_t findPoint(const cg3::Point2d& point) const;
+        size_t getEntryNode(const cg3::Point2d& point) const;
+
+        size_t getResolution() const;
+        size_t getMemoryUsage() const;
+        double getAverageEntryDepth() const;
+    private:
+        const DAG& dag;
+
+        /* Entry DAGnode of each cell of a resolution x resolution grid, row by row from the bottom left one */
+        std::vector<StoredIndex> entries;
+        size_t resolution;
+        double minX, minY;
+        double cellWidth, cellHeight;
+
+        size_t totalEntryDepth;
+        double averageEntryDepth;
+
+        size_t cell(const cg3::Point2d& point) const;
+        void buildCells(const size_t& column1, const size_t& column2, const size_t& row1, const size_t& row2,
+                        const size_t& node, const size_t& depth);
+        size_t findEntryNode(const size_t& start, const double& x1, const double& y1, const double& x2, const double& y2,
+                             size_t& depth) const;
+};
+
+#endif // DAG_JUMP_TABLE_H
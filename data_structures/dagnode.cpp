@@ -1,51 +1,31 @@
 #include "dagnode.h"
 
 /**
- * @brief DAGnode Constructor for the "point" node type
- * @param p, the Point which will be store as value
- */
-DAGnode::DAGnode(const cg3::Point2d& p) {
-    type = point;
-    pointValue = p;
-    left = SIZE_MAX;
-    right = SIZE_MAX;
-}
-
-/**
- * @brief DAGnode Constructor for the "point" node type
- * @param p, the Point which will be store as value
- * @param l, index of the left sub-tree inside the DAG
- * @param r, index of the right sub-tree inside the DAG
- */
-DAGnode::DAGnode(const cg3::Point2d& p, const size_t& l, const size_t& r) {
-    type = point;
-    pointValue = p;
-    left = l;
-    right = r;
-}
-
-/**
- * @brief DAGnode Constructor for the "segment" node type
- * @param s, the Segment which will be store as value
- */
-DAGnode::DAGnode(const cg3::Segment2d& s) {
-    type = segment;
-    segmentValue = s;
-    left = SIZE_MAX;
-    right = SIZE_MAX;
+ * @brief DAGnode Constructor for the "point" and "segment" node types
+ * @param type, the type of the DAGnode
+ * @param value, the id (inside the TrapezoidalMap) of the Point or of the Segment which will be store as value
+ */
+DAGnode::DAGnode(const NodeType& type, const size_t& value) {
+    assert(type != trapezoid);
+    this->type = type;
+    this->value = toStoredIndex(value);
+    left = NO_STORED_INDEX;
+    right = NO_STORED_INDEX;
 }
 
 /**
- * @brief DAGnode Constructor for the "segment" node type
- * @param s, the Segment which will be store as value
+ * @brief DAGnode Constructor for the "point" and "segment" node types
+ * @param type, the type of the DAGnode
+ * @param value, the id (inside the TrapezoidalMap) of the Point or of the Segment which will be store as value
  * @param l, index of the left sub-tree inside the DAG
  * @param r, index of the right sub-tree inside the DAG
  */
-DAGnode::DAGnode(const cg3::Segment2d& s, const size_t& l, const size_t& r) {
-    type = segment;
-    segmentValue = s;
-    left = l;
-    right = r;
+DAGnode::DAGnode(const NodeType& type, const size_t& value, const size_t& l, const size_t& r) {
+    assert(type != trapezoid);
+    this->type = type;
+    this->value = toStoredIndex(value);
+    left = toStoredIndex(l);
+    right = toStoredIndex(r);
 }
 
 /**
@@ -54,9 +34,9 @@ DAGnode::DAGnode(const cg3::Segment2d& s, const size_t& l, const size_t& r) {
  */
 DAGnode::DAGnode(const size_t& t) {
     type = trapezoid;
-    trapezoidValue = t;
-    left = SIZE_MAX;
-    right = SIZE_MAX;
+    value = toStoredIndex(t);
+    left = NO_STORED_INDEX;
+    right = NO_STORED_INDEX;
 }
 
 /**
@@ -67,34 +47,34 @@ DAGnode::DAGnode(const size_t& t) {
  */
 DAGnode::DAGnode(const size_t& t, const size_t& l, const size_t& r) {
     type = trapezoid;
-    trapezoidValue = t;
-    left = l;
-    right = r;
+    value = toStoredIndex(t);
+    left = toStoredIndex(l);
+    right = toStoredIndex(r);
 }
 
 /**
  * @brief Setter for the left sub-tree
  * @param leftNode, the new DAGnode index
  */
-void DAGnode::setLeft(const size_t& leftNode) { left = leftNode; }
+void DAGnode::setLeft(const size_t& leftNode) { left = toStoredIndex(leftNode); }
 
 /**
  * @brief Setter for the right sub-tree
  * @param rightNode, the new DAGnode index
  */
-void DAGnode::setRight(const size_t& rightNode) { right = rightNode; }
+void DAGnode::setRight(const size_t& rightNode) { right = toStoredIndex(rightNode); }
 
 /**
  * @brief Getter for the left sub-tree DAGnode index
  * @return the left sub-tree DAGnode index
  */
-size_t DAGnode::getLeft() const { return left; }
+size_t DAGnode::getLeft() const { return fromStoredIndex(left); }
 
 /**
  * @brief Getter for the right sub-tree DAGnode index
  * @return the right sub-tree DAGnode index
  */
-size_t DAGnode::getRight() const { return right; }
+size_t DAGnode::getRight() const { return fromStoredIndex(right); }
 
 /**
  * @brief Checks the type of the DAGnode
@@ -116,27 +96,27 @@ bool DAGnode::isTrapezoidNode() const { return (type == trapezoid); }
 
 /**
  * @brief Getter DAGnode value of a Point type node
- * @return the pointValue
+ * @return the id of the Point inside the TrapezoidalMap
  */
-const cg3::Point2d& DAGnode::getPointValue() const {
+size_t DAGnode::getPointId() const {
     assert(type == point);
-    return pointValue;
+    return fromStoredIndex(value);
 }
 
 /**
  * @brief Getter DAGnode value of a Segment type node
- * @return the segmentValue
+ * @return the id of the Segment inside the TrapezoidalMap
  */
-const cg3::Segment2d& DAGnode::getSegmentValue() const {
+size_t DAGnode::getSegmentId() const {
     assert(type == segment);
-    return segmentValue;
+    return fromStoredIndex(value);
 }
 
 /**
  * @brief Getter DAGnode value of a Trapezoid type node
- * @return the trapezoidValue
+ * @return the index of the Trapezoid inside the TrapezoidalMap
  */
 size_t DAGnode::getTrapezoidValue() const {
     assert(type == trapezoid);
-    return trapezoidValue;
+    return fromStoredIndex(value);
 }
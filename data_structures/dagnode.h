@@ -1,35 +1,32 @@
 #ifndef DAGNODE_H
 #define DAGNODE_H
 
-#include <cg3/geometry/segment2.h>
-#include <cg3/geometry/point2.h>
+#include "stored_index.h"
 
 /**
  * @brief Base element of a DAG.
  * A DAGnode is represented by:
  *      a "type" which can be "point", "segment" or "trapezoid.
- *      "pointValue", a "segmentValue" and a "trapezoidValue":
- *      only one can be used based on the type of the node.
+ *      a "value": the id (inside the TrapezoidalMap) of the Point of a "point" node
+ *      or of the Segment of a "segment" node, the index of the Trapezoid of a "trapezoid" node.
  *      "left" and "right" which are the indexes of the left
  *      and right sub-trees inside the DAG
+ * The geometry is kept only once, by the TrapezoidalMap, and read through the DAG.
  */
 class DAGnode {
+    public:
+        enum NodeType : uint8_t {point, segment, trapezoid};
     private:
-        enum NodeType {point, segment, trapezoid};
-        NodeType type;
+        StoredIndex value;
 
-        cg3::Point2d pointValue;
-        cg3::Segment2d segmentValue;
-        size_t trapezoidValue;
+        StoredIndex left;
+        StoredIndex right;
 
-        size_t left;
-        size_t right;
+        /* Last, to not waste space in padding */
+        NodeType type;
     public:
-        DAGnode(const cg3::Point2d& p);
-        DAGnode(const cg3::Point2d& p, const size_t& l, const size_t& r);
-
-        DAGnode(const cg3::Segment2d& s);
-        DAGnode(const cg3::Segment2d& s, const size_t& l, const size_t& r);
+        DAGnode(const NodeType& type, const size_t& value);
+        DAGnode(const NodeType& type, const size_t& value, const size_t& l, const size_t& r);
 
         DAGnode(const size_t& t);
         DAGnode(const size_t& t, const size_t& l, const size_t& r);
@@ -44,8 +41,8 @@ class DAGnode {
         bool isSegmentNode() const;
         bool isTrapezoidNode() const;
 
-        const cg3::Point2d& getPointValue() const;
-        const cg3::Segment2d& getSegmentValue() const;
+        size_t getPointId() const;
+        size_t getSegmentId() const;
         size_t getTrapezoidValue() const;
 };
 
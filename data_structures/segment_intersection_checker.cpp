@@ -2,9 +2,48 @@
 
 #include <cg3/geometry/intersections2.h>
 
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
+
+#include "algorithms/segment_intersections.h"
+#include "utils/utils.h"
+
+#define CHECK_MIN_SEGMENTS_PER_THREAD 1024
+
+/* Relative distance within which an endpoint is considered lying on another segment,
+   it has to stay below the tolerance used by the sweep line to test the segments close to an endpoint */
+#define ENDPOINT_TOUCH_TOLERANCE (256 * std::numeric_limits<double>::epsilon())
+
+namespace {
+
+/**
+ * @brief Checks if a point lies on a segment within rounding error, strictly between its endpoints
+ */
+bool isTouchingPoint(const cg3::Segment2d& segment, const cg3::Point2d& point)
+{
+    const cg3::Point2d& a = segment.p1();
+    const cg3::Point2d& b = segment.p2();
+
+    double dx = b.x() - a.x();
+    double dy = b.y() - a.y();
+    double projection = dx * (point.x() - a.x()) + dy * (point.y() - a.y());
+    if (projection <= 0 || projection >= dx * dx + dy * dy)
+        return false;
+
+    double det = dx * (point.y() - a.y()) - dy * (point.x() - a.x());
+    double scale = std::fabs(dx) * (std::fabs(point.y()) + std::fabs(a.y())) +
+                   std::fabs(dy) * (std::fabs(point.x()) + std::fabs(a.x()));
+    return std::fabs(det) <= ENDPOINT_TOUCH_TOLERANCE * scale;
+}
+
+}
+
 SegmentIntersectionChecker::SegmentIntersectionChecker()
     : aabbTree(&aabbValueExtractor),
-      keyOverlapChecker(&checkSegmentIntersection)
+      keyOverlapChecker(&checkSegmentIntersection),
+      backend(aabbTreeBackend)
 {
 
 }
@@ -13,6 +52,21 @@ void SegmentIntersectionChecker::insert(const cg3::Segment2d& seg) {
     aabbTree.insert(seg);
 }
 
+/**
+ * @brief Inserts a set of segments, building the tree at once if it is empty.
+ * @param segVec, the segments to insert
+ */
+void SegmentIntersectionChecker::insert(const std::vector<cg3::Segment2d>& segVec) {
+    if (aabbTree.empty()) {
+        aabbTree.construction(segVec);
+    }
+    else {
+        for (const cg3::Segment2d& seg : segVec) {
+            aabbTree.insert(seg);
+        }
+    }
+}
+
 size_t SegmentIntersectionChecker::countIntersections(const cg3::Segment2d& seg) {
     std::vector<cg3::AABBTree<2, cg3::Segment2d>::iterator> out;
     aabbTree.aabbOverlapQuery(seg, std::back_inserter(out), this->keyOverlapChecker);
@@ -42,6 +96,84 @@ bool SegmentIntersectionChecker::checkIntersections(const std::vector<cg3::Segme
     return false;
 }
 
+/**
+ * @brief Checks, for each segment, if it intersects a stored segment.
+ * The queries do not modify the tree, so they are split among multiple threads.
+ * @param segVec, the segments to check
+ * @param result, will contain, for each segment, true if it intersects a stored segment
+ * @param threads, the number of threads to use (0 to use all the available cores)
+ */
+void SegmentIntersectionChecker::checkIntersections(const std::vector<cg3::Segment2d>& segVec, std::vector<bool>& result, const unsigned int& threads) {
+    /* std::vector<bool> cannot be written by multiple threads */
+    std::vector<char> intersecting(segVec.size(), false);
+
+    Utils::parallelFor(segVec.size(), threads, CHECK_MIN_SEGMENTS_PER_THREAD, [&](const size_t& begin, const size_t& end) {
+        for (size_t i = begin; i < end; i++) {
+            intersecting[i] = aabbTree.aabbOverlapCheck(segVec[i], this->keyOverlapChecker);
+        }
+    });
+
+    result.assign(intersecting.begin(), intersecting.end());
+}
+
+/**
+ * @brief Finds all the pairs of intersecting segments in a set.
+ *
+ * The AABB tree backend runs a query for each segment, on multiple threads,
+ * and it is fast for short segments. The sweep line backend runs on a single thread
+ * in O((n + k) log n), and it does not degrade with long segments overlapping many bounding boxes.
+ * The sweep line tests the segments that touch with exact arithmetic and the ones passing within rounding error
+ * of an endpoint, so it finds the same pairs of the AABB tree backend, unless checkSegmentIntersection
+ * reports a crossing far from the endpoints because of rounding errors.
+ * @param segVec, the segments (they must be all different)
+ * @param result, will contain the pairs (i, j), with i < j, of the indexes of the intersecting segments,
+ * sorted in lexicographic order
+ * @param backend, the backend to use
+ * @param threads, the number of threads to use (0 to use all the available cores), AABB tree backend only
+ */
+void SegmentIntersectionChecker::findAllIntersections(
+        const std::vector<cg3::Segment2d>& segVec,
+        std::vector<std::pair<size_t, size_t>>& result,
+        const Backend& backend,
+        const unsigned int& threads)
+{
+    result.clear();
+
+    if (backend == sweepLineBackend) {
+        Algorithms::findSegmentIntersections(segVec, &checkSegmentIntersection, result);
+        return;
+    }
+
+    std::vector<std::pair<cg3::Segment2d, size_t>> indexedSegVec;
+    indexedSegVec.reserve(segVec.size());
+    for (size_t i = 0; i < segVec.size(); i++) {
+        indexedSegVec.push_back(std::make_pair(segVec[i], i));
+    }
+    assert(std::unordered_set<cg3::Segment2d>(segVec.begin(), segVec.end()).size() == segVec.size());
+
+    IndexedAABBTree indexedTree(indexedSegVec, &aabbValueExtractor);
+
+    std::mutex resultMutex;
+    Utils::parallelFor(segVec.size(), threads, CHECK_MIN_SEGMENTS_PER_THREAD, [&](const size_t& begin, const size_t& end) {
+        std::vector<std::pair<size_t, size_t>> chunkResult;
+        std::vector<IndexedAABBTree::iterator> out;
+        for (size_t i = begin; i < end; i++) {
+            out.clear();
+            indexedTree.aabbOverlapQuery(segVec[i], std::back_inserter(out), &checkSegmentIntersection);
+            for (IndexedAABBTree::iterator& it : out) {
+                if (i < *it) {
+                    chunkResult.push_back(std::make_pair(i, *it));
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        result.insert(result.end(), chunkResult.begin(), chunkResult.end());
+    });
+
+    std::sort(result.begin(), result.end());
+}
+
 double SegmentIntersectionChecker::aabbValueExtractor(
         const cg3::Segment2d& segment,
         const cg3::AABBValueType& valueType,
@@ -69,7 +201,43 @@ double SegmentIntersectionChecker::aabbValueExtractor(
 
 bool SegmentIntersectionChecker::checkSegmentIntersection(const cg3::Segment2d& seg1, const cg3::Segment2d& seg2)
 {
-    return cg3::checkSegmentIntersection2(seg1, seg2, true);
+    /* The rounding errors of checkSegmentIntersection2 depend on the order of its arguments,
+       the Segments are passed in a fixed order so that the result does not */
+    const cg3::Segment2d& first = seg2 < seg1 ? seg2 : seg1;
+    const cg3::Segment2d& second = seg2 < seg1 ? seg1 : seg2;
+
+    char code;
+    cg3::checkSegmentIntersection2(first, second, code);
+    if (code == '1')
+        return true;
+    if (code != '0')
+        return false;
+
+    /* An endpoint lying on the other segment is seen by checkSegmentIntersection2 only when the rounding
+       is favourable (e.g. on a decimal grid): it is tested with a tolerance, so that all the segments
+       ending at the same point get the same answer */
+    return isTouchingPoint(first, second.p1()) || isTouchingPoint(first, second.p2()) ||
+           isTouchingPoint(second, first.p1()) || isTouchingPoint(second, first.p2());
+}
+
+SegmentIntersectionChecker::Backend SegmentIntersectionChecker::getBackend() const
+{
+    return backend;
+}
+
+/**
+ * @brief Sets the backend used to find the intersections inside a set of segments,
+ * the stored segments are always kept in the AABB tree.
+ * @param backend, the backend
+ */
+void SegmentIntersectionChecker::setBackend(const Backend& backend)
+{
+    this->backend = backend;
+}
+
+bool SegmentIntersectionChecker::empty()
+{
+    return aabbTree.empty();
 }
 
 void SegmentIntersectionChecker::clear()
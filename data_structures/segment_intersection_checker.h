@@ -11,16 +11,33 @@ public:
 
     typedef cg3::AABBTree<2, cg3::Segment2d> AABBTree;
     typedef AABBTree::KeyOverlapChecker KeyOverlapChecker;
+    typedef cg3::AABBTree<2, cg3::Segment2d, size_t> IndexedAABBTree;
+
+    /* Backend used to find the intersections inside a set of segments */
+    enum Backend {aabbTreeBackend, sweepLineBackend};
 
     SegmentIntersectionChecker();
 
     void insert(const cg3::Segment2d& seg);
+    void insert(const std::vector<cg3::Segment2d>& segVec);
 
     size_t countIntersections(const cg3::Segment2d& seg);
     bool checkIntersections(const cg3::Segment2d& seg);
 
     size_t countIntersection(const std::vector<cg3::Segment2d>& segVec);
     bool checkIntersections(const std::vector<cg3::Segment2d>& segVec);
+    void checkIntersections(const std::vector<cg3::Segment2d>& segVec, std::vector<bool>& result, const unsigned int& threads = 0);
+
+    static void findAllIntersections(
+            const std::vector<cg3::Segment2d>& segVec,
+            std::vector<std::pair<size_t, size_t>>& result,
+            const Backend& backend = aabbTreeBackend,
+            const unsigned int& threads = 0);
+
+    Backend getBackend() const;
+    void setBackend(const Backend& backend);
+
+    bool empty();
 
 
     static double aabbValueExtractor(
@@ -38,6 +55,8 @@ private:
     AABBTree aabbTree;
     KeyOverlapChecker keyOverlapChecker;
 
+    Backend backend;
+
 };
 
 #endif // SEGMENTINTERSECTIONCHECKER_H
@@ -0,0 +1,46 @@
+#ifndef STORED_INDEX_H
+#define STORED_INDEX_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+/* Define TRAPEZOIDALMAP_64BIT_INDEXES to store the indexes kept inside Trapezoids and DAGnodes
+ * on 64 bits, by default they are stored on 32 bits (maps of up to about 4 billion elements) */
+#ifdef TRAPEZOIDALMAP_64BIT_INDEXES
+typedef uint64_t StoredIndex;
+#else
+typedef uint32_t StoredIndex;
+#endif
+
+/* Stored in place of SIZE_MAX, the missing index */
+static const StoredIndex NO_STORED_INDEX = std::numeric_limits<StoredIndex>::max();
+
+/**
+ * @brief Converts an index to the type used to store it, SIZE_MAX becomes NO_STORED_INDEX.
+ * An index too large to be stored aborts the program, in release builds too:
+ * truncating it would silently corrupt the map.
+ * @param index, the index
+ * @return the stored index
+ */
+inline StoredIndex toStoredIndex(const size_t& index) {
+    if(index != SIZE_MAX && index >= NO_STORED_INDEX) {
+        std::fprintf(stderr, "Index %zu cannot be stored, define TRAPEZOIDALMAP_64BIT_INDEXES for larger maps\n", index);
+        std::abort();
+    }
+    return index == SIZE_MAX ? NO_STORED_INDEX : static_cast<StoredIndex>(index);
+}
+
+/**
+ * @brief Converts a stored index back to an index, NO_STORED_INDEX becomes SIZE_MAX.
+ * @param index, the stored index
+ * @return the index
+ */
+inline size_t fromStoredIndex(const StoredIndex& index) {
+    return index == NO_STORED_INDEX ? SIZE_MAX : static_cast<size_t>(index);
+}
+
+#endif // STORED_INDEX_H
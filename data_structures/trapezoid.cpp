@@ -4,142 +4,142 @@
  * @brief Trapezoid basic Constructor
  */
 Trapezoid::Trapezoid() {
-    top = cg3::Segment2d(cg3::Point2d(0, 0), cg3::Point2d(0, 0));
-    bot = cg3::Segment2d(cg3::Point2d(0, 0), cg3::Point2d(0, 0));
-    leftP = cg3::Point2d(0, 0);
-    rightP = cg3::Point2d(0, 0);
+    top = NO_STORED_INDEX;
+    bot = NO_STORED_INDEX;
+    leftP = NO_STORED_INDEX;
+    rightP = NO_STORED_INDEX;
 
-    topLeftNeighbor = SIZE_MAX;
-    topRightNeighbor = SIZE_MAX;
-    botLeftNeighbor = SIZE_MAX;
-    botRightNeighbor = SIZE_MAX;
+    topLeftNeighbor = NO_STORED_INDEX;
+    topRightNeighbor = NO_STORED_INDEX;
+    botLeftNeighbor = NO_STORED_INDEX;
+    botRightNeighbor = NO_STORED_INDEX;
 
-    DAGlink = SIZE_MAX;
+    DAGlink = NO_STORED_INDEX;
 }
 
 /**
  * @brief Trapezoid Constructor
- * @param top, Segment delimiting the upper boundary
- * @param bot, Segment delimiting the lower boundary
- * @param leftP, Point delimiting the left boundary
- * @param rightP, Point delimiting the right boundary
- */
-Trapezoid::Trapezoid(const cg3::Segment2d &top, const cg3::Segment2d &bot,
-                     const cg3::Point2d &leftP, const cg3::Point2d &rightP) {
-    this->top = top;
-    this->bot = bot;
-    this->leftP = leftP;
-    this->rightP = rightP;
+ * @param top, id of the Segment delimiting the upper boundary
+ * @param bot, id of the Segment delimiting the lower boundary
+ * @param leftP, id of the Point delimiting the left boundary
+ * @param rightP, id of the Point delimiting the right boundary
+ */
+Trapezoid::Trapezoid(const size_t& top, const size_t& bot,
+                     const size_t& leftP, const size_t& rightP) {
+    this->top = toStoredIndex(top);
+    this->bot = toStoredIndex(bot);
+    this->leftP = toStoredIndex(leftP);
+    this->rightP = toStoredIndex(rightP);
 
-    topLeftNeighbor = SIZE_MAX;
-    topRightNeighbor = SIZE_MAX;
-    botLeftNeighbor = SIZE_MAX;
-    botRightNeighbor = SIZE_MAX;
+    topLeftNeighbor = NO_STORED_INDEX;
+    topRightNeighbor = NO_STORED_INDEX;
+    botLeftNeighbor = NO_STORED_INDEX;
+    botRightNeighbor = NO_STORED_INDEX;
 
-    DAGlink = SIZE_MAX;
+    DAGlink = NO_STORED_INDEX;
 }
 
 /**
  * @brief Setter for the top segment
- * @param segment, the new top segment
+ * @param segment, id of the new top segment
  */
-void Trapezoid::setTop(const cg3::Segment2d& segment) { top = segment; }
+void Trapezoid::setTopId(const size_t& segment) { top = toStoredIndex(segment); }
 /**
  * @brief Setter for the bot segment
- * @param segment, the new bot segment
+ * @param segment, id of the new bot segment
  */
-void Trapezoid::setBot(const cg3::Segment2d& segment) { bot = segment; }
+void Trapezoid::setBotId(const size_t& segment) { bot = toStoredIndex(segment); }
 /**
  * @brief Setter for the left point
- * @param point, the new left point
+ * @param point, id of the new left point
  */
-void Trapezoid::setLeftP(const cg3::Point2d& point) { leftP = point; }
+void Trapezoid::setLeftPId(const size_t& point) { leftP = toStoredIndex(point); }
 /**
  * @brief Setter for the right point
- * @param point, the new right point
+ * @param point, id of the new right point
  */
-void Trapezoid::setRightP(const cg3::Point2d& point) { rightP = point; }
+void Trapezoid::setRightPId(const size_t& point) { rightP = toStoredIndex(point); }
 
 /**
  * @brief Setter for the top left neighbor
  * @param trapezoid, index of the new top left neighbor
  */
 void Trapezoid::setTopLeftNeighbor(const size_t& trapezoid) {
-    topLeftNeighbor = trapezoid;
+    topLeftNeighbor = toStoredIndex(trapezoid);
 }
 /**
  * @brief Setter for the top right neighbor
  * @param trapezoid, index of the new top right neighbor
  */
 void Trapezoid::setTopRightNeighbor(const size_t& trapezoid) {
-    topRightNeighbor = trapezoid;
+    topRightNeighbor = toStoredIndex(trapezoid);
 }
 /**
  * @brief Setter for the bot left neighbor
  * @param trapezoid, index of the new bot left neighbor
  */
 void Trapezoid::setBotLeftNeighbor(const size_t& trapezoid) {
-    botLeftNeighbor = trapezoid;
+    botLeftNeighbor = toStoredIndex(trapezoid);
 }
 /**
  * @brief Setter for the bot right neighbor
  * @param trapezoid, index of the new bot right neighbor
  */
 void Trapezoid::setBotRightNeighbor(const size_t& trapezoid) {
-    botRightNeighbor = trapezoid;
+    botRightNeighbor = toStoredIndex(trapezoid);
 }
 
 /**
  * @brief Getter for the top segment
- * @return The top segment
+ * @return The id of the top segment
  */
-const cg3::Segment2d& Trapezoid::getTop() const { return top; }
+size_t Trapezoid::getTopId() const { return top; }
 /**
  * @brief Getter for the bot segment
- * @return The bot segment
+ * @return The id of the bot segment
  */
-const cg3::Segment2d& Trapezoid::getBot() const { return bot; }
+size_t Trapezoid::getBotId() const { return bot; }
 /**
  * @brief Getter for the left point
- * @return The left point
+ * @return The id of the left point
  */
-const cg3::Point2d& Trapezoid::getLeftP() const { return leftP; }
+size_t Trapezoid::getLeftPId() const { return leftP; }
 /**
  * @brief Getter for the right point
- * @return The right point
+ * @return The id of the right point
  */
-const cg3::Point2d& Trapezoid::getRightP() const { return rightP; }
+size_t Trapezoid::getRightPId() const { return rightP; }
 
 
 /**
  * @brief Getter for the top left neighbor
  * @return the index of the top left neighbor
  */
-size_t Trapezoid::getTopLeftNeighbor() const { return topLeftNeighbor; }
+size_t Trapezoid::getTopLeftNeighbor() const { return fromStoredIndex(topLeftNeighbor); }
 /**
  * @brief Getter for the top right neighbor
  * @return the index of the top right neighbor
  */
-size_t Trapezoid::getTopRightNeighbor() const { return topRightNeighbor; }
+size_t Trapezoid::getTopRightNeighbor() const { return fromStoredIndex(topRightNeighbor); }
 /**
  * @brief Getter for the bot left neighbor
  * @return the index of the bot left neighbor
  */
-size_t Trapezoid::getBotLeftNeighbor() const { return botLeftNeighbor; }
+size_t Trapezoid::getBotLeftNeighbor() const { return fromStoredIndex(botLeftNeighbor); }
 /**
  * @brief Getter for the bot right neighbor
  * @return the index of the bot right neighbor
  */
-size_t Trapezoid::getBotRightNeighbor() const { return botRightNeighbor; }
+size_t Trapezoid::getBotRightNeighbor() const { return fromStoredIndex(botRightNeighbor); }
 
 /**
  * @brief Setter for the DAG link
  * @param nodeIndex, the index of the DAGnode inside the DAG that represents this Trapezoid
  */
-void Trapezoid::setDAGlink(const size_t& nodeIndex) { DAGlink = nodeIndex; }
+void Trapezoid::setDAGlink(const size_t& nodeIndex) { DAGlink = toStoredIndex(nodeIndex); }
 
 /**
  * @brief Getter for the DAG link
  * @return the index of the DAGnode inside the DAG that represents this Trapezoid
  */
-size_t Trapezoid::getDAGlink() const { return DAGlink; }
+size_t Trapezoid::getDAGlink() const { return fromStoredIndex(DAGlink); }
@@ -4,10 +4,14 @@
 #include <cg3/geometry/segment2.h>
 #include <cg3/geometry/point2.h>
 
+#include "stored_index.h"
+
 /**
  * @brief Base element of the TrapezoidalMap.
  * A Trapezoid is represented by two segments describing its upper and lower boundaries
  * and two points to describe its left and right boundaries.
+ * The segments and the points are not stored inside the Trapezoid: it keeps their ids
+ * inside the segments of the TrapezoidalMap, which returns their geometry.
  * A Trapezoid can also have up to four neighbors:
  * topLeft, topRight, botLeft, botRight.
  * They are represented with the index they have inside the TrapezoidalMap's vector.
@@ -16,36 +20,36 @@
  */
 class Trapezoid {
     private:
-        cg3::Segment2d top;
-        cg3::Segment2d bot;
-        cg3::Point2d leftP;
-        cg3::Point2d rightP;
+        StoredIndex top;
+        StoredIndex bot;
+        StoredIndex leftP;
+        StoredIndex rightP;
 
-        size_t topLeftNeighbor;
-        size_t topRightNeighbor;
-        size_t botLeftNeighbor;
-        size_t botRightNeighbor;
+        StoredIndex topLeftNeighbor;
+        StoredIndex topRightNeighbor;
+        StoredIndex botLeftNeighbor;
+        StoredIndex botRightNeighbor;
 
-        size_t DAGlink;
+        StoredIndex DAGlink;
     public:
         Trapezoid();
-        Trapezoid(const cg3::Segment2d& top, const cg3::Segment2d& bot,
-                  const cg3::Point2d& leftP, const cg3::Point2d& rightP);
+        Trapezoid(const size_t& top, const size_t& bot,
+                  const size_t& leftP, const size_t& rightP);
 
-        void setTop(const cg3::Segment2d& segment);
-        void setBot(const cg3::Segment2d& segment);
-        void setLeftP(const cg3::Point2d& point);
-        void setRightP(const cg3::Point2d& point);
+        void setTopId(const size_t& segment);
+        void setBotId(const size_t& segment);
+        void setLeftPId(const size_t& point);
+        void setRightPId(const size_t& point);
 
         void setTopLeftNeighbor(const size_t& trapezoid);
         void setTopRightNeighbor(const size_t& trapezoid);
         void setBotLeftNeighbor(const size_t& trapezoid);
         void setBotRightNeighbor(const size_t& trapezoid);
 
-        const cg3::Segment2d& getTop() const;
-        const cg3::Segment2d& getBot() const;
-        const cg3::Point2d& getLeftP() const;
-        const cg3::Point2d& getRightP() const;
+        size_t getTopId() const;
+        size_t getBotId() const;
+        size_t getLeftPId() const;
+        size_t getRightPId() const;
 
         size_t getTopLeftNeighbor() const;
         size_t getTopRightNeighbor() const;
@@ -1,38 +1,54 @@
 #include "trapezoidalmap.h"
 
+#include <algorithm>
+
 /**
  * @brief TrapezoidalMap Constructor
  * @param botLeft, bot left point of the bounding box
  * @param topRight, top right point of the bounding box
  */
-TrapezoidalMap::TrapezoidalMap(const cg3::Point2d& botLeft, const cg3::Point2d& topRight) {
+TrapezoidalMap::TrapezoidalMap(const cg3::Point2d& botLeft, const cg3::Point2d& topRight):
+    releasedSegments(0),
+    observer(nullptr)
+{
     trapezoids = std::vector<Trapezoid>();
 
-    boundingBox = Trapezoid(
-                cg3::Segment2d(cg3::Point2d(botLeft.x(), topRight.y()), topRight),
-                cg3::Segment2d(botLeft, cg3::Point2d(topRight.x(), botLeft.y())),
-                botLeft,
-                topRight);
+    segments.push_back(cg3::Segment2d(cg3::Point2d(botLeft.x(), topRight.y()), topRight));
+    segments.push_back(cg3::Segment2d(botLeft, cg3::Point2d(topRight.x(), botLeft.y())));
+    releasedSegmentFlags.assign(2, false);
+
+    /* botLeft is the left endpoint of the bot Segment, topRight the right endpoint of the top one */
+    boundingBox = Trapezoid(0, 1, getLeftPointId(1), getRightPointId(0));
 
     trapezoids.push_back(boundingBox);
     trapezoids[0].setDAGlink(0);
 
-    freeSlotIndex = SIZE_MAX;
+    freeSlotFlags.push_back(false);
 }
 
+/**
+ * @brief TrapezoidalMap Destructor
+ */
+TrapezoidalMap::~TrapezoidalMap() { }
+
 /**
  * @brief Adds a Trapezoid to the vector and returns the index in which it has been inserted
  * @param trapezoid, the Trapezoid to insert
  * @return The index in which the Trapezoid has been inserted
  */
 size_t TrapezoidalMap::addTrapezoid(const Trapezoid& trapezoid) {
-    if(freeSlotIndex == SIZE_MAX) {
+    if(freeSlots.empty()) {
         trapezoids.push_back(trapezoid);
+        freeSlotFlags.push_back(false);
+
+        if(observer != nullptr)
+            observer->trapezoidUpdated(trapezoids.size()-1);
         return trapezoids.size()-1;
     } else {
-        updateTrapezoid(freeSlotIndex, trapezoid);
-        size_t newIndex = freeSlotIndex;
-        freeSlotIndex = SIZE_MAX;
+        size_t newIndex = freeSlots.back();
+        freeSlots.pop_back();
+        freeSlotFlags[newIndex] = false;
+        updateTrapezoid(newIndex, trapezoid);
         return newIndex;
     }
 }
@@ -44,7 +60,11 @@ size_t TrapezoidalMap::addTrapezoid(const Trapezoid& trapezoid) {
  */
 void TrapezoidalMap::updateTrapezoid(const size_t& index, const Trapezoid& trapezoid) {
     assert(index >= 0 && index < trapezoids.size());
+    history.save(index, trapezoids[index]);
     trapezoids[index] = trapezoid;
+
+    if(observer != nullptr)
+        observer->trapezoidUpdated(index);
 }
 
 /**
@@ -67,6 +87,177 @@ const Trapezoid& TrapezoidalMap::getTrapezoid(const size_t& index) const {
     return trapezoids[index];
 }
 
+/**
+ * @brief Adds a Segment to the ones the Trapezoids can refer to.
+ *
+ * The Segments are never removed (but by clear), so their ids stay valid:
+ * a Segment removed from the map is only released (see releaseSegment).
+ * @param segment, the Segment (from left to right)
+ * @return the id of the Segment
+ */
+size_t TrapezoidalMap::addSegment(const cg3::Segment2d& segment) {
+    assert(segment.p1().x() <= segment.p2().x());
+    segments.push_back(segment);
+    releasedSegmentFlags.push_back(false);
+    return segments.size()-1;
+}
+
+/**
+ * @brief Returns the Segment with a given id
+ * @param id, id of the Segment
+ * @return the Segment
+ */
+const cg3::Segment2d& TrapezoidalMap::getSegment(const size_t& id) const {
+    assert(id < segments.size());
+    return segments[id];
+}
+
+/**
+ * @brief Returns the Point with a given id, an endpoint of one of the Segments
+ * @param id, id of the Point
+ * @return the Point
+ */
+const cg3::Point2d& TrapezoidalMap::getPoint(const size_t& id) const {
+    assert(id / 2 < segments.size());
+    return id % 2 == 0 ? segments[id / 2].p1() : segments[id / 2].p2();
+}
+
+/**
+ * @brief Returns the number of Segments, the ones of the bounding box included
+ * @return the number of Segments
+ */
+size_t TrapezoidalMap::getSegmentCount() const {
+    return segments.size();
+}
+
+/**
+ * @brief Marks a Segment as removed from the map.
+ * Its id stays valid, since the DAG can still refer to it, until the map is cleared
+ * (e.g. by a rebuild, which reclaims the released Segments).
+ * @param id, id of the Segment
+ */
+void TrapezoidalMap::releaseSegment(const size_t& id) {
+    assert(id >= 2 && id < segments.size() && !releasedSegmentFlags[id]);
+    releasedSegmentFlags[id] = true;
+    releasedSegments++;
+}
+
+/**
+ * @brief Checks if a Segment has been removed from the map
+ * @param id, id of the Segment
+ * @return true if the Segment has been released
+ */
+bool TrapezoidalMap::isReleasedSegment(const size_t& id) const {
+    assert(id < segments.size());
+    return releasedSegmentFlags[id];
+}
+
+/**
+ * @brief Returns the number of Segments removed from the map since it has been cleared
+ * @return the number of released Segments
+ */
+size_t TrapezoidalMap::getReleasedSegmentCount() const {
+    return releasedSegments;
+}
+
+/**
+ * @brief Returns all the Segments, indexed by their ids (e.g. to read them without a call for each one)
+ * @return the Segments
+ */
+const std::vector<cg3::Segment2d>& TrapezoidalMap::getSegments() const {
+    return segments;
+}
+
+/**
+ * @brief Returns the id of the left endpoint of a Segment
+ * @param segment, id of the Segment
+ * @return the id of the Point
+ */
+size_t TrapezoidalMap::getLeftPointId(const size_t& segment) {
+    return segment * 2;
+}
+
+/**
+ * @brief Returns the id of the right endpoint of a Segment
+ * @param segment, id of the Segment
+ * @return the id of the Point
+ */
+size_t TrapezoidalMap::getRightPointId(const size_t& segment) {
+    return segment * 2 + 1;
+}
+
+/**
+ * @brief Returns the top Segment of a Trapezoid
+ * @param trapezoid, the Trapezoid
+ * @return the top Segment
+ */
+const cg3::Segment2d& TrapezoidalMap::getTop(const Trapezoid& trapezoid) const {
+    return getSegment(trapezoid.getTopId());
+}
+
+/**
+ * @brief Returns the bot Segment of a Trapezoid
+ * @param trapezoid, the Trapezoid
+ * @return the bot Segment
+ */
+const cg3::Segment2d& TrapezoidalMap::getBot(const Trapezoid& trapezoid) const {
+    return getSegment(trapezoid.getBotId());
+}
+
+/**
+ * @brief Returns the left Point of a Trapezoid
+ * @param trapezoid, the Trapezoid
+ * @return the left Point
+ */
+const cg3::Point2d& TrapezoidalMap::getLeftP(const Trapezoid& trapezoid) const {
+    return getPoint(trapezoid.getLeftPId());
+}
+
+/**
+ * @brief Returns the right Point of a Trapezoid
+ * @param trapezoid, the Trapezoid
+ * @return the right Point
+ */
+const cg3::Point2d& TrapezoidalMap::getRightP(const Trapezoid& trapezoid) const {
+    return getPoint(trapezoid.getRightPId());
+}
+
+/**
+ * @brief Returns the top Segment of the Trapezoid located in the index position
+ * @param index, index of the Trapezoid
+ * @return the top Segment
+ */
+const cg3::Segment2d& TrapezoidalMap::getTop(const size_t& index) const {
+    return getTop(getTrapezoid(index));
+}
+
+/**
+ * @brief Returns the bot Segment of the Trapezoid located in the index position
+ * @param index, index of the Trapezoid
+ * @return the bot Segment
+ */
+const cg3::Segment2d& TrapezoidalMap::getBot(const size_t& index) const {
+    return getBot(getTrapezoid(index));
+}
+
+/**
+ * @brief Returns the left Point of the Trapezoid located in the index position
+ * @param index, index of the Trapezoid
+ * @return the left Point
+ */
+const cg3::Point2d& TrapezoidalMap::getLeftP(const size_t& index) const {
+    return getLeftP(getTrapezoid(index));
+}
+
+/**
+ * @brief Returns the right Point of the Trapezoid located in the index position
+ * @param index, index of the Trapezoid
+ * @return the right Point
+ */
+const cg3::Point2d& TrapezoidalMap::getRightP(const size_t& index) const {
+    return getRightP(getTrapezoid(index));
+}
+
 /**
  * @brief Splits the Trapezoid in 4 new Trapezoids.
  *
@@ -75,19 +266,21 @@ const Trapezoid& TrapezoidalMap::getTrapezoid(const size_t& index) const {
  *
  * All the neighbors will also be updated.
  * @param trpzToReplace, index of the Trapezoid to replace
- * @param segment, Segment to compute the spit around
+ * @param segment, id of the Segment to compute the spit around
  * @return an Array containing the 4 indexes of the new Trapezoids
  */
-const std::array<size_t, 4> TrapezoidalMap::split4(const size_t& trpzToReplace, const cg3::Segment2d& segment) {
+const std::array<size_t, 4> TrapezoidalMap::split4(const size_t& trpzToReplace, const size_t& segment) {
     /* Reference of the Trapezoid that needs to be splitted */
     Trapezoid origin = trapezoids[trpzToReplace];
+    size_t p1 = getLeftPointId(segment);
+    size_t p2 = getRightPointId(segment);
 
     /* Creation of the new 4 Trapezoids */
-    Trapezoid t1 = Trapezoid(origin.getTop(), origin.getBot(), origin.getLeftP(), segment.p1());
+    Trapezoid t1 = Trapezoid(origin.getTopId(), origin.getBotId(), origin.getLeftPId(), p1);
     t1.setDAGlink(origin.getDAGlink());
-    Trapezoid t2 = Trapezoid(origin.getTop(), segment, segment.p1(), segment.p2());
-    Trapezoid t3 = Trapezoid(segment, origin.getBot(), segment.p1(), segment.p2());
-    Trapezoid t4 = Trapezoid(origin.getTop(), origin.getBot(), segment.p2(), origin.getRightP());
+    Trapezoid t2 = Trapezoid(origin.getTopId(), segment, p1, p2);
+    Trapezoid t3 = Trapezoid(segment, origin.getBotId(), p1, p2);
+    Trapezoid t4 = Trapezoid(origin.getTopId(), origin.getBotId(), p2, origin.getRightPId());
 
     /* Indexes in the Trapezoids Vector of the new 4 Trapezoids.
      * The first one will replace the one that is being splitted */
@@ -141,18 +334,19 @@ const std::array<size_t, 4> TrapezoidalMap::split4(const size_t& trpzToReplace,
  *
  * The neighbors will also be updated.
  * @param trpzToReplace, index of the Trapezoid to replace
- * @param segment, Segment to compute the spit around
+ * @param segment, id of the Segment to compute the spit around
  * @return an Array containing the 3 indexes of the new Trapezoids
  */
-const std::array<size_t, 3> TrapezoidalMap::split3L(const size_t& trpzToReplace, const cg3::Segment2d& segment) {
+const std::array<size_t, 3> TrapezoidalMap::split3L(const size_t& trpzToReplace, const size_t& segment) {
     /* Reference of the Trapezoid that needs to be splitted */
     Trapezoid origin = trapezoids[trpzToReplace];
+    size_t p1 = getLeftPointId(segment);
 
     /* Creation of the new 3 Trapezoids */
-    Trapezoid t1 = Trapezoid(origin.getTop(), origin.getBot(), origin.getLeftP(), segment.p1());
+    Trapezoid t1 = Trapezoid(origin.getTopId(), origin.getBotId(), origin.getLeftPId(), p1);
     t1.setDAGlink(origin.getDAGlink());
-    Trapezoid t2 = Trapezoid(origin.getTop(), segment, segment.p1(), origin.getRightP());
-    Trapezoid t3 = Trapezoid(segment, origin.getBot(), segment.p1(), origin.getRightP());
+    Trapezoid t2 = Trapezoid(origin.getTopId(), segment, p1, origin.getRightPId());
+    Trapezoid t3 = Trapezoid(segment, origin.getBotId(), p1, origin.getRightPId());
 
     /* Indexes in the Trapezoids Vector of the new 3 Trapezoids.
      * The first one will replace the one that is being splitted */
@@ -198,20 +392,20 @@ const std::array<size_t, 3> TrapezoidalMap::split3L(const size_t& trpzToReplace,
  *
  * The neighbors will also be updated.
  * @param trpzToReplace, index of the Trapezoid to replace
- * @param segment, Segment to compute the spit around
+ * @param segment, id of the Segment to compute the spit around
  * @param trpzPrevSplitTop, index of the left neighbor Trapezoid from a previous split (above the segment).
  * @param trpzPrevSplitBot, index of the left neighbor Trapezoid from a previous split (under the segment).
  * @return an Array containing the 3 indexes of the new Trapezoids
  */
-const std::array<size_t, 2> TrapezoidalMap::split2(const size_t& trpzToReplace, const cg3::Segment2d& segment,
+const std::array<size_t, 2> TrapezoidalMap::split2(const size_t& trpzToReplace, const size_t& segment,
                                                     const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot) {
     /* Reference of the Trapezoid that needs to be splitted */
     Trapezoid origin = trapezoids[trpzToReplace];
 
     /* Creation of the new 2 Trapezoids */
-    Trapezoid t1 = Trapezoid(origin.getTop(), segment, origin.getLeftP(), origin.getRightP());
+    Trapezoid t1 = Trapezoid(origin.getTopId(), segment, origin.getLeftPId(), origin.getRightPId());
     t1.setDAGlink(origin.getDAGlink());
-    Trapezoid t2 = Trapezoid(segment, origin.getBot(), origin.getLeftP(), origin.getRightP());
+    Trapezoid t2 = Trapezoid(segment, origin.getBotId(), origin.getLeftPId(), origin.getRightPId());
 
     /* Updating the Vector */
     updateTrapezoid(trpzToReplace, t1);
@@ -257,20 +451,21 @@ const std::array<size_t, 2> TrapezoidalMap::split2(const size_t& trpzToReplace,
  *
  * The neighbors will also be updated.
  * @param trpzToReplace, index of the Trapezoid to replace
- * @param segment, Segment to compute the spit around
+ * @param segment, id of the Segment to compute the spit around
  * @param trpzPrevSplitTop, index of the left neighbor Trapezoid from a previous split (above the segment).
  * @param trpzPrevSplitBot, index of the left neighbor Trapezoid from a previous split (under the segment).
  * @return an Array containing the 3 indexes of the new Trapezoids
  */
-const std::array<size_t, 3> TrapezoidalMap::split3R(const size_t& trpzToReplace, const cg3::Segment2d& segment,
+const std::array<size_t, 3> TrapezoidalMap::split3R(const size_t& trpzToReplace, const size_t& segment,
                                                     const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot) {
     /* Reference of the Trapezoid that needs to be splitted */
     Trapezoid origin = trapezoids[trpzToReplace];
+    size_t p2 = getRightPointId(segment);
 
     /* Creation of the new 3 Trapezoids */
-    Trapezoid t1 = Trapezoid(origin.getTop(), segment, origin.getLeftP(), segment.p2());
-    Trapezoid t2 = Trapezoid(segment, origin.getBot(), origin.getLeftP(), segment.p2());
-    Trapezoid t3 = Trapezoid(origin.getTop(), origin.getBot(), segment.p2(), origin.getRightP());
+    Trapezoid t1 = Trapezoid(origin.getTopId(), segment, origin.getLeftPId(), p2);
+    Trapezoid t2 = Trapezoid(segment, origin.getBotId(), origin.getLeftPId(), p2);
+    Trapezoid t3 = Trapezoid(origin.getTopId(), origin.getBotId(), p2, origin.getRightPId());
     t3.setDAGlink(origin.getDAGlink());
 
     /* Indexes in the Trapezoids Vector of the new 3 Trapezoids
@@ -329,10 +524,11 @@ void TrapezoidalMap::merge(const size_t& leftTrpzIndex, const size_t& rightTrpzI
     Trapezoid t2 = trapezoids[rightTrpzIndex];
 
     /* "Deleting" the right Trapezoid */
-    freeSlotIndex = rightTrpzIndex;
+    freeTrapezoid(rightTrpzIndex);
 
     /* Updating the right point and the right nighbors */
-    trapezoids[leftTrpzIndex].setRightP(t2.getRightP());
+    history.save(leftTrpzIndex, trapezoids[leftTrpzIndex]);
+    trapezoids[leftTrpzIndex].setRightPId(t2.getRightPId());
 
     trapezoids[leftTrpzIndex].setTopRightNeighbor(t2.getTopRightNeighbor());
     trapezoids[leftTrpzIndex].setBotRightNeighbor(t2.getBotRightNeighbor());
@@ -342,6 +538,120 @@ void TrapezoidalMap::merge(const size_t& leftTrpzIndex, const size_t& rightTrpzI
         trapezoids[trapezoids[leftTrpzIndex].getTopRightNeighbor()].setTopLeftNeighbor(leftTrpzIndex);
     if(trapezoids[leftTrpzIndex].getBotRightNeighbor() != SIZE_MAX)
         trapezoids[trapezoids[leftTrpzIndex].getBotRightNeighbor()].setBotLeftNeighbor(leftTrpzIndex);
+
+    if(observer != nullptr)
+        observer->trapezoidUpdated(leftTrpzIndex);
+}
+
+/**
+ * @brief Replaces the Trapezoid located in the index position with a new one.
+ *
+ * Unlike the split operations, the neighbors of the other Trapezoids are not updated:
+ * it is used by the algorithms that rebuild a whole region of the map.
+ * @param index, index of the Trapezoid to replace
+ * @param trapezoid, new Trapezoid
+ */
+void TrapezoidalMap::replaceTrapezoid(const size_t& index, const Trapezoid& trapezoid) {
+    updateTrapezoid(index, trapezoid);
+}
+
+/**
+ * @brief Marks the Trapezoid located in the index position as deleted,
+ * its slot will be reused by the next added Trapezoid.
+ *
+ * The neighbors and the DAG are not updated: no other Trapezoid and no leaf should refer to it.
+ * @param index, index of the Trapezoid to delete
+ */
+void TrapezoidalMap::freeTrapezoid(const size_t& index) {
+    assert(index >= 0 && index < trapezoids.size() && !freeSlotFlags[index]);
+
+    freeSlots.push_back(index);
+    freeSlotFlags[index] = true;
+
+    if(observer != nullptr)
+        observer->trapezoidFreed(index);
+}
+
+/**
+ * @brief Removes a free slot from the vector.
+ *
+ * The last Trapezoid is moved in its place and the neighbors of the moved Trapezoid are updated.
+ * The last Trapezoid must not be a free slot.
+ * @param index, index of the free slot to remove (it has to be already removed from the free list)
+ * @return the previous index of the moved Trapezoid, SIZE_MAX if no Trapezoid has been moved
+ */
+size_t TrapezoidalMap::removeTrapezoid(const size_t& index) {
+    assert(index >= 0 && index < trapezoids.size() && freeSlotFlags[index]);
+    assert(!history.isEnabled());
+
+    size_t last = trapezoids.size()-1;
+    assert(index == last || !freeSlotFlags[last]);
+
+    if(index == last) {
+        trapezoids.pop_back();
+        freeSlotFlags.pop_back();
+
+        if(observer != nullptr)
+            observer->trapezoidRemoved(index, SIZE_MAX);
+        return SIZE_MAX;
+    }
+
+    trapezoids[index] = trapezoids[last];
+    trapezoids.pop_back();
+    freeSlotFlags[index] = false;
+    freeSlotFlags.pop_back();
+
+    /* Updating the neighbors that were pointing to the moved Trapezoid */
+    const Trapezoid& moved = trapezoids[index];
+    std::array<size_t, 4> neighbors = {moved.getTopLeftNeighbor(), moved.getTopRightNeighbor(),
+                                       moved.getBotLeftNeighbor(), moved.getBotRightNeighbor()};
+    for(const size_t& neighbor : neighbors) {
+        if(neighbor == SIZE_MAX)
+            continue;
+
+        Trapezoid& t = trapezoids[neighbor];
+        if(t.getTopLeftNeighbor() == last)
+            t.setTopLeftNeighbor(index);
+        if(t.getTopRightNeighbor() == last)
+            t.setTopRightNeighbor(index);
+        if(t.getBotLeftNeighbor() == last)
+            t.setBotLeftNeighbor(index);
+        if(t.getBotRightNeighbor() == last)
+            t.setBotRightNeighbor(index);
+    }
+
+    if(observer != nullptr)
+        observer->trapezoidRemoved(index, last);
+    return last;
+}
+
+/**
+ * @brief Removes all the free slots from the vector, moving the last Trapezoids in their place.
+ *
+ * The neighbors are updated, the leaves of the DAG pointing to the moved Trapezoids
+ * have to be updated by the caller.
+ * It cannot be used in persistent mode, the indexes of the previous versions would change.
+ * @return the new indexes of the moved Trapezoids
+ */
+std::vector<size_t> TrapezoidalMap::compact() {
+    std::vector<size_t> movedTrapezoids;
+
+    /* Removing the free slots from the last one, the Trapezoid moved in their place is never a free slot */
+    std::sort(freeSlots.begin(), freeSlots.end());
+    while(!freeSlots.empty()) {
+        size_t index = freeSlots.back();
+        freeSlots.pop_back();
+
+        if(removeTrapezoid(index) != SIZE_MAX)
+            movedTrapezoids.push_back(index);
+    }
+
+    /* A Trapezoid can be moved more than once, only its last position is still valid */
+    movedTrapezoids.erase(std::remove_if(movedTrapezoids.begin(), movedTrapezoids.end(),
+                                         [this](const size_t& index) { return index >= trapezoids.size(); }),
+                          movedTrapezoids.end());
+
+    return movedTrapezoids;
 }
 
 /**
@@ -355,12 +665,22 @@ size_t TrapezoidalMap::getTrapezoidalMapSize() const {
 }
 
 /**
- * @brief Returns the index of the Trapezoid considered as "deleted" after a Merge operation.
- * Returns SIZE_MAX if no Trapezoid has been deleted yet.
- * @return thethe index of the Trapezoid considered as "deleted".
+ * @brief Returns the number of Trapezoid inside the map,
+ * without counting the ones considered as "deleted".
+ * @return the number of live Trapezoid inside the map.
  */
-size_t TrapezoidalMap::getFreeSlotIndex() const {
-    return freeSlotIndex;
+size_t TrapezoidalMap::liveTrapezoidCount() const {
+    return trapezoids.size() - freeSlots.size();
+}
+
+/**
+ * @brief Tells if the index position holds a "deleted" Trapezoid.
+ * @param index, the index
+ * @return true if the position is a free slot
+ */
+bool TrapezoidalMap::isFreeSlot(const size_t& index) const {
+    assert(index >= 0 && index < trapezoids.size());
+    return freeSlotFlags[index];
 }
 
 /**
@@ -371,14 +691,100 @@ const Trapezoid& TrapezoidalMap::getBoundingBox() const {
     return boundingBox;
 }
 
+/**
+ * @brief Getter for the observer notified of the changes of the Trapezoids.
+ * @return the observer, nullptr if there is none
+ */
+TrapezoidalMapObserver* TrapezoidalMap::getObserver() const {
+    return observer;
+}
+
+/**
+ * @brief Sets the observer notified of the changes of the Trapezoids.
+ * @param observer, the observer, nullptr to remove it
+ */
+void TrapezoidalMap::setObserver(TrapezoidalMapObserver* observer) {
+    this->observer = observer;
+}
+
+/**
+ * @brief Enables or disables the persistent mode.
+ *
+ * In persistent mode the boundaries of every overwritten Trapezoid are kept, so that
+ * the map can be read as it was at each committed version (at the cost of O(1) space per change).
+ * Enabling it, the current map becomes the version 0; disabling it, the previous versions are dropped.
+ * @param persistent, true to enable the persistent mode
+ */
+void TrapezoidalMap::setPersistent(const bool& persistent) {
+    history.setEnabled(persistent);
+}
+
+/**
+ * @brief Tells if the map is in persistent mode.
+ * @return true if the previous versions are kept
+ */
+bool TrapezoidalMap::isPersistent() const {
+    return history.isEnabled();
+}
+
+/**
+ * @brief Returns the number of committed versions of the map (in persistent mode).
+ * @return the last committed version
+ */
+size_t TrapezoidalMap::getVersion() const {
+    return history.getVersion();
+}
+
+/**
+ * @brief Commits the changes made since the last commit as a new version (in persistent mode).
+ * @return the new version
+ */
+size_t TrapezoidalMap::commitVersion() {
+    return history.commit(trapezoids.size());
+}
+
+/**
+ * @brief Returns the Trapezoid located in the index position as it was at a committed version.
+ *
+ * Only its boundaries are the ones of that version, its neighbors and its DAG link are the current ones.
+ * @param index, index of the Trapezoid, it must exist at that version
+ * @param version, the version, at most the last committed one
+ * @return the Trapezoid
+ */
+const Trapezoid& TrapezoidalMap::getTrapezoid(const size_t& index, const size_t& version) const {
+    return history.get(trapezoids, index, version);
+}
+
+/**
+ * @brief Reserves space for a given number of Trapezoids,
+ * to avoid reallocations of the vector while the map is being built.
+ * @param size, the number of Trapezoids to reserve space for
+ */
+void TrapezoidalMap::reserve(const size_t& size) {
+    trapezoids.reserve(size);
+
+    if(observer != nullptr)
+        observer->mapReserved(size);
+}
+
 /**
  * @brief Clears the Trapezoidal Map restoring the original Trapezoid.
+ * In persistent mode, the previous versions are dropped and the empty map becomes the version 0.
  */
 void TrapezoidalMap::clear() {
     trapezoids.clear();
+    segments.resize(2);
+    releasedSegmentFlags.assign(2, false);
+    releasedSegments = 0;
 
     trapezoids.push_back(boundingBox);
     trapezoids[0].setDAGlink(0);
 
-    freeSlotIndex = SIZE_MAX;
+    freeSlots.clear();
+    freeSlotFlags.assign(1, false);
+
+    history.clear();
+
+    if(observer != nullptr)
+        observer->mapCleared();
 }
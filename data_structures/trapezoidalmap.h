@@ -2,46 +2,106 @@
 #define TRAPEZOIDALMAP_H
 
 #include "trapezoid.h"
+#include "trapezoidalmap_observer.h"
+#include "version_history.h"
 
 /**
  * @brief The TrapezoidalMap class.
  * A TrapezoidalMap is defined through a vector of Trapezoid.
+ * The Segments of the map are kept in a second vector, shared by all the Trapezoids
+ * which refer to them (and to their endpoints) through their ids.
+ * An optional TrapezoidalMapObserver is notified of every change of the Trapezoids.
+ * In persistent mode the overwritten Trapezoids are kept, so that the map can be read
+ * as it was at every committed version.
  */
 class TrapezoidalMap {
     private:
         std::vector<Trapezoid> trapezoids;
 
-        /* Will keep the index of the "deleted" Trapezoid after a Merge operation
-           in order to put a new Trapezoid in that position when needed
+        /* The first two Segments are the top and the bot of the bounding box,
+           the Point with id p is the endpoint p%2 (0 for the left one) of the Segment p/2 */
+        std::vector<cg3::Segment2d> segments;
+
+        /* Segments removed from the map, still in the vector until it is cleared,
+           and their number */
+        std::vector<bool> releasedSegmentFlags;
+        size_t releasedSegments;
+
+        /* Will keep the indexes of the "deleted" Trapezoids (e.g. after a Merge operation)
+           in order to put new Trapezoids in those positions when needed
            to not leave holes in the vector */
-        size_t freeSlotIndex;
+        std::vector<size_t> freeSlots;
+        std::vector<bool> freeSlotFlags;
 
         /* Will store a copy of the first Trapezoid (the bounding box)
            in order to be able to restore its primal state */
         Trapezoid boundingBox;
 
+        TrapezoidalMapObserver* observer;
+
+        /* Previous boundaries of the Trapezoids in persistent mode, the neighbors and the DAG links
+           of the previous versions are not kept */
+        VersionHistory<Trapezoid> history;
+
         size_t addTrapezoid(const Trapezoid& trapezoid);
         void updateTrapezoid(const size_t& index, const Trapezoid& trapezoid);
+        size_t removeTrapezoid(const size_t& index);
     public:
         TrapezoidalMap();
         TrapezoidalMap(const cg3::Point2d& botLeft, const cg3::Point2d& topRight);
+        virtual ~TrapezoidalMap();
 
         Trapezoid& getTrapezoid(const size_t& index);
         const Trapezoid& getTrapezoid(const size_t& index) const;
 
-        const std::array<size_t, 4> split4(const size_t& trpzToReplace, const cg3::Segment2d& segment);
-        const std::array<size_t, 3> split3L(const size_t& trpzToReplace, const cg3::Segment2d& segment);
-        const std::array<size_t, 2> split2(const size_t& trpzToReplace, const cg3::Segment2d& segment,
-                                         const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot);
-        const std::array<size_t, 3> split3R(const size_t& trpzToReplace, const cg3::Segment2d& segment,
-                                          const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot);
+        size_t addSegment(const cg3::Segment2d& segment);
+        const cg3::Segment2d& getSegment(const size_t& id) const;
+        const cg3::Point2d& getPoint(const size_t& id) const;
+        size_t getSegmentCount() const;
+        void releaseSegment(const size_t& id);
+        bool isReleasedSegment(const size_t& id) const;
+        size_t getReleasedSegmentCount() const;
+        const std::vector<cg3::Segment2d>& getSegments() const;
+        static size_t getLeftPointId(const size_t& segment);
+        static size_t getRightPointId(const size_t& segment);
+
+        const cg3::Segment2d& getTop(const Trapezoid& trapezoid) const;
+        const cg3::Segment2d& getBot(const Trapezoid& trapezoid) const;
+        const cg3::Point2d& getLeftP(const Trapezoid& trapezoid) const;
+        const cg3::Point2d& getRightP(const Trapezoid& trapezoid) const;
+        const cg3::Segment2d& getTop(const size_t& index) const;
+        const cg3::Segment2d& getBot(const size_t& index) const;
+        const cg3::Point2d& getLeftP(const size_t& index) const;
+        const cg3::Point2d& getRightP(const size_t& index) const;
+
+        const std::array<size_t, 4> split4(const size_t& trpzToReplace, const size_t& segment);
+        const std::array<size_t, 3> split3L(const size_t& trpzToReplace, const size_t& segment);
+        const std::array<size_t, 2> split2(const size_t& trpzToReplace, const size_t& segment,
+                                                 const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot);
+        const std::array<size_t, 3> split3R(const size_t& trpzToReplace, const size_t& segment,
+                                                  const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot);
 
         void merge(const size_t& leftTrpzIndex, const size_t& rightTrpzIndex);
 
+        void replaceTrapezoid(const size_t& index, const Trapezoid& trapezoid);
+        void freeTrapezoid(const size_t& index);
+        std::vector<size_t> compact();
+
         size_t getTrapezoidalMapSize() const;
-        size_t getFreeSlotIndex() const;
+        size_t liveTrapezoidCount() const;
+        bool isFreeSlot(const size_t& index) const;
         const Trapezoid& getBoundingBox() const;
 
+        TrapezoidalMapObserver* getObserver() const;
+        void setObserver(TrapezoidalMapObserver* observer);
+
+        void setPersistent(const bool& persistent);
+        bool isPersistent() const;
+        size_t getVersion() const;
+        size_t commitVersion();
+        const Trapezoid& getTrapezoid(const size_t& index, const size_t& version) const;
+
+        void reserve(const size_t& size);
         void clear();
 };
 
@@ -42,75 +42,107 @@ size_t TrapezoidalMapDataset::addPoint(const cg3::Point2d& point, bool& pointIns
     return id;
 }
 
+/**
+ * @brief Adds a segment, if it does not intersect any stored segment.
+ *
+ * A segment with an endpoint lying on a stored segment (or the other way round) within rounding error
+ * is rejected like a touching one: these near-touching endpoints were accepted when the rounding missed the touch.
+ * @param segment, the segment to add
+ * @param segmentInserted, will be true if the segment has been inserted
+ * @return the id of the segment or the maximum size_t if it has not been inserted
+ */
 size_t TrapezoidalMapDataset::addSegment(const cg3::Segment2d& segment, bool& segmentInserted)
 {
-    size_t id;
+    size_t id = std::numeric_limits<size_t>::max();
 
-    cg3::Segment2d orderedSegment = segment;
-    if (segment.p2() < segment.p1()) {
-        orderedSegment.setP1(segment.p2());
-        orderedSegment.setP2(segment.p1());
-    }
-
-    bool found;
-    findSegment(orderedSegment, found);
-
-    bool degenerate = orderedSegment.p1() == orderedSegment.p2();
+    cg3::Segment2d orderedSegment = orderSegment(segment);
 
     segmentInserted = false;
-    id = std::numeric_limits<size_t>::max();
-
-    if (!degenerate && !found) {
-        bool generalPosition = true;
-
-        bool foundPoint1;
-        size_t id1 = findPoint(orderedSegment.p1(), foundPoint1);
-        bool foundPoint2;
-        size_t id2 = findPoint(orderedSegment.p2(), foundPoint2);
 
-        if (!foundPoint1 && xCoordSet.find(orderedSegment.p1().x()) != xCoordSet.end()) {
-            generalPosition = false;
-        }
-        if (!foundPoint2 && xCoordSet.find(orderedSegment.p2().x()) != xCoordSet.end()) {
-            generalPosition = false;
-        }
+    if (canInsertOrderedSegment(orderedSegment)) {
+        bool intersecting = intersectionChecker.checkIntersections(orderedSegment);
 
-        if (generalPosition) {
-            bool intersecting = intersectionChecker.checkIntersections(orderedSegment);
-
-            if (!intersecting) {
-                segmentInserted = true;
+        if (!intersecting) {
+            segmentInserted = true;
 
-                id = indexedSegments.size();
+            id = insertOrderedSegment(orderedSegment);
 
-                if (!foundPoint1) {
-                    bool insertedPoint1;
-                    id1 = addPoint(orderedSegment.p1(), insertedPoint1);
-                    assert(insertedPoint1);
-                }
+            intersectionChecker.insert(orderedSegment);
+        }
+    }
 
-                if (!foundPoint2) {
-                    bool insertedPoint2;
-                    id2 = addPoint(orderedSegment.p2(), insertedPoint2);
-                    assert(insertedPoint2);
-                }
-                assert(id1 != id2 && id1 < points.size() && id2 < points.size());
+    return id;
+}
 
-                IndexedSegment2d indexedSegment(id1, id2);
-                if (indexedSegment.second < indexedSegment.first) {
-                    std::swap(indexedSegment.first, indexedSegment.second);
-                }
+/**
+ * @brief Adds a batch of segments, with the same result of calling addSegment on each of them in order.
+ *
+ * The intersections of the new segments with the stored ones and among themselves
+ * are computed at once (on multiple threads), then the segments are accepted in order:
+ * a segment is rejected if it intersects a stored segment or an accepted segment of the batch.
+ * The intersecting pairs of the batch are kept in memory while it is processed.
+ * @param segments, the segments to add
+ * @param segmentsInserted, will contain, for each segment, true if it has been inserted
+ * @param threads, the number of threads to use (0 to use all the available cores)
+ * @return for each segment, its id or the maximum size_t if it has not been inserted
+ */
+std::vector<size_t> TrapezoidalMapDataset::addSegments(const std::vector<cg3::Segment2d>& segments, std::vector<bool>& segmentsInserted, const unsigned int& threads)
+{
+    std::vector<size_t> ids(segments.size(), std::numeric_limits<size_t>::max());
+    segmentsInserted.assign(segments.size(), false);
+
+    //Candidates: non-degenerate segments not stored yet, duplicates in the batch
+    //are rejected as the first occurrence is either inserted or rejected for the same reason
+    std::vector<size_t> candidates;
+    std::vector<cg3::Segment2d> candidateSegments;
+    std::unordered_set<cg3::Segment2d> batchSegments;
+    for (size_t i = 0; i < segments.size(); i++) {
+        cg3::Segment2d orderedSegment = orderSegment(segments[i]);
+
+        bool found;
+        findSegment(orderedSegment, found);
+
+        if (!found && orderedSegment.p1() != orderedSegment.p2() && batchSegments.insert(orderedSegment).second) {
+            candidates.push_back(i);
+            candidateSegments.push_back(orderedSegment);
+        }
+    }
 
-                indexedSegments.push_back(indexedSegment);
+    //Intersections with the stored segments
+    std::vector<bool> intersectingStored(candidates.size(), false);
+    if (!intersectionChecker.empty()) {
+        intersectionChecker.checkIntersections(candidateSegments, intersectingStored, threads);
+    }
 
-                segmentMap.insert(std::make_pair(indexedSegment, id));
+    //Intersections among the new segments, grouped by the segment coming later
+    std::vector<std::pair<size_t, size_t>> intersections;
+    SegmentIntersectionChecker::findAllIntersections(candidateSegments, intersections, intersectionChecker.getBackend(), threads);
+    std::sort(intersections.begin(), intersections.end(),
+              [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        return a.second < b.second;
+    });
+
+    //Accepting the segments in order
+    std::vector<bool> accepted(candidates.size(), false);
+    std::vector<cg3::Segment2d> acceptedSegments;
+    size_t nextIntersection = 0;
+    for (size_t c = 0; c < candidates.size(); c++) {
+        bool intersecting = intersectingStored[c];
+        for (; nextIntersection < intersections.size() && intersections[nextIntersection].second == c; nextIntersection++) {
+            intersecting |= accepted[intersections[nextIntersection].first];
+        }
 
-                intersectionChecker.insert(orderedSegment);
-            }
+        if (!intersecting && canInsertOrderedSegment(candidateSegments[c])) {
+            accepted[c] = true;
+            segmentsInserted[candidates[c]] = true;
+            ids[candidates[c]] = insertOrderedSegment(candidateSegments[c]);
+            acceptedSegments.push_back(candidateSegments[c]);
         }
     }
 
-    return id;
+    intersectionChecker.insert(acceptedSegments);
+
+    return ids;
 }
 
 size_t TrapezoidalMapDataset::addIndexedSegment(const IndexedSegment2d& indexedSegment, bool& segmentInserted)
@@ -245,6 +277,15 @@ std::vector<cg3::Segment2d> TrapezoidalMapDataset::getSegments() const
     return segments;
 }
 
+/**
+ * @brief Returns a view over the stored segments, which does not allocate anything.
+ * @return the view
+ */
+TrapezoidalMapDataset::SegmentRange TrapezoidalMapDataset::getSegmentRange() const
+{
+    return SegmentRange(points, indexedSegments);
+}
+
 cg3::Segment2d TrapezoidalMapDataset::getSegment(size_t id) const
 {
     return cg3::Segment2d(points[indexedSegments[id].first], points[indexedSegments[id].second]);
@@ -270,6 +311,152 @@ const cg3::BoundingBox2& TrapezoidalMapDataset::getBoundingBox() const
     return boundingBox;
 }
 
+SegmentIntersectionChecker::Backend TrapezoidalMapDataset::getIntersectionBackend() const
+{
+    return intersectionChecker.getBackend();
+}
+
+/**
+ * @brief Sets the backend used by addSegments to find the intersections among the new segments.
+ * @param backend, the backend
+ */
+void TrapezoidalMapDataset::setIntersectionBackend(const SegmentIntersectionChecker::Backend& backend)
+{
+    intersectionChecker.setBackend(backend);
+}
+
+cg3::Segment2d TrapezoidalMapDataset::orderSegment(const cg3::Segment2d& segment)
+{
+    cg3::Segment2d orderedSegment = segment;
+    if (segment.p2() < segment.p1()) {
+        orderedSegment.setP1(segment.p2());
+        orderedSegment.setP2(segment.p1());
+    }
+    return orderedSegment;
+}
+
+bool TrapezoidalMapDataset::canInsertOrderedSegment(const cg3::Segment2d& orderedSegment)
+{
+    bool found;
+    findSegment(orderedSegment, found);
+
+    bool degenerate = orderedSegment.p1() == orderedSegment.p2();
+
+    if (degenerate || found)
+        return false;
+
+    bool foundPoint1;
+    findPoint(orderedSegment.p1(), foundPoint1);
+    bool foundPoint2;
+    findPoint(orderedSegment.p2(), foundPoint2);
+
+    if (!foundPoint1 && xCoordSet.find(orderedSegment.p1().x()) != xCoordSet.end()) {
+        return false;
+    }
+    if (!foundPoint2 && xCoordSet.find(orderedSegment.p2().x()) != xCoordSet.end()) {
+        return false;
+    }
+
+    return true;
+}
+
+size_t TrapezoidalMapDataset::insertOrderedSegment(const cg3::Segment2d& orderedSegment)
+{
+    size_t id = indexedSegments.size();
+
+    bool foundPoint1;
+    size_t id1 = findPoint(orderedSegment.p1(), foundPoint1);
+    bool foundPoint2;
+    size_t id2 = findPoint(orderedSegment.p2(), foundPoint2);
+
+    if (!foundPoint1) {
+        bool insertedPoint1;
+        id1 = addPoint(orderedSegment.p1(), insertedPoint1);
+        assert(insertedPoint1);
+    }
+
+    if (!foundPoint2) {
+        bool insertedPoint2;
+        id2 = addPoint(orderedSegment.p2(), insertedPoint2);
+        assert(insertedPoint2);
+    }
+    assert(id1 != id2 && id1 < points.size() && id2 < points.size());
+
+    IndexedSegment2d indexedSegment(id1, id2);
+    if (indexedSegment.second < indexedSegment.first) {
+        std::swap(indexedSegment.first, indexedSegment.second);
+    }
+
+    indexedSegments.push_back(indexedSegment);
+
+    segmentMap.insert(std::make_pair(indexedSegment, id));
+
+    return id;
+}
+
+TrapezoidalMapDataset::SegmentRange::SegmentRange(const std::vector<cg3::Point2d>& points, const std::vector<IndexedSegment2d>& indexedSegments) :
+    points(&points),
+    indexedSegments(&indexedSegments)
+{
+
+}
+
+TrapezoidalMapDataset::SegmentRange::const_iterator TrapezoidalMapDataset::SegmentRange::begin() const
+{
+    return const_iterator(*points, *indexedSegments, 0);
+}
+
+TrapezoidalMapDataset::SegmentRange::const_iterator TrapezoidalMapDataset::SegmentRange::end() const
+{
+    return const_iterator(*points, *indexedSegments, indexedSegments->size());
+}
+
+size_t TrapezoidalMapDataset::SegmentRange::size() const
+{
+    return indexedSegments->size();
+}
+
+bool TrapezoidalMapDataset::SegmentRange::empty() const
+{
+    return indexedSegments->empty();
+}
+
+cg3::Segment2d TrapezoidalMapDataset::SegmentRange::operator[](size_t id) const
+{
+    const IndexedSegment2d& indexedSegment = (*indexedSegments)[id];
+    return cg3::Segment2d((*points)[indexedSegment.first], (*points)[indexedSegment.second]);
+}
+
+TrapezoidalMapDataset::SegmentRange::const_iterator::const_iterator(const std::vector<cg3::Point2d>& points, const std::vector<IndexedSegment2d>& indexedSegments, size_t id) :
+    points(&points),
+    indexedSegments(&indexedSegments),
+    id(id)
+{
+
+}
+
+cg3::Segment2d TrapezoidalMapDataset::SegmentRange::const_iterator::operator*() const
+{
+    const IndexedSegment2d& indexedSegment = (*indexedSegments)[id];
+    return cg3::Segment2d((*points)[indexedSegment.first], (*points)[indexedSegment.second]);
+}
+
+TrapezoidalMapDataset::SegmentRange::const_iterator& TrapezoidalMapDataset::SegmentRange::const_iterator::operator++()
+{
+    id++;
+    return *this;
+}
+
+bool TrapezoidalMapDataset::SegmentRange::const_iterator::operator==(const const_iterator& other) const
+{
+    return id == other.id;
+}
+
+bool TrapezoidalMapDataset::SegmentRange::const_iterator::operator!=(const const_iterator& other) const
+{
+    return id != other.id;
+}
+
 void TrapezoidalMapDataset::clear()
 {
     points.clear();
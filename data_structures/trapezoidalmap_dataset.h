@@ -2,6 +2,7 @@
 #define TRAPEZOIDALMAP_DATASET_H
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 
@@ -22,10 +23,55 @@ public:
 
     typedef std::pair<size_t, size_t> IndexedSegment2d;
 
+    /**
+     * @brief Read-only view over the stored segments.
+     * The segments are built on demand from the points and the indexed segments,
+     * without copying them. It is invalidated by any change of the dataset.
+     */
+    class SegmentRange {
+
+    public:
+
+        class const_iterator {
+
+        public:
+
+            const_iterator(const std::vector<cg3::Point2d>& points, const std::vector<IndexedSegment2d>& indexedSegments, size_t id);
+
+            cg3::Segment2d operator*() const;
+            const_iterator& operator++();
+            bool operator==(const const_iterator& other) const;
+            bool operator!=(const const_iterator& other) const;
+
+        private:
+
+            const std::vector<cg3::Point2d>* points;
+            const std::vector<IndexedSegment2d>* indexedSegments;
+            size_t id;
+
+        };
+
+        SegmentRange(const std::vector<cg3::Point2d>& points, const std::vector<IndexedSegment2d>& indexedSegments);
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        size_t size() const;
+        bool empty() const;
+        cg3::Segment2d operator[](size_t id) const;
+
+    private:
+
+        const std::vector<cg3::Point2d>* points;
+        const std::vector<IndexedSegment2d>* indexedSegments;
+
+    };
+
     TrapezoidalMapDataset();
 
     size_t addPoint(const cg3::Point2d& point, bool& pointInserted);
     size_t addSegment(const cg3::Segment2d& segment, bool& segmentInserted);
+    std::vector<size_t> addSegments(const std::vector<cg3::Segment2d>& segments, std::vector<bool>& segmentsInserted, const unsigned int& threads = 0);
     size_t addIndexedSegment(const IndexedSegment2d& segment, bool& segmentInserted);
 
     size_t findPoint(const cg3::Point2d& point, bool& found);
@@ -40,6 +86,7 @@ public:
     const cg3::Point2d& getPoint(size_t id) const;
 
     std::vector<cg3::Segment2d> getSegments() const;
+    SegmentRange getSegmentRange() const;
     cg3::Segment2d getSegment(size_t id) const;
 
     const std::vector<IndexedSegment2d>& getIndexedSegments() const;
@@ -48,10 +95,17 @@ public:
 
     const cg3::BoundingBox2& getBoundingBox() const;
 
+    SegmentIntersectionChecker::Backend getIntersectionBackend() const;
+    void setIntersectionBackend(const SegmentIntersectionChecker::Backend& backend);
+
     void clear();
 
 private:
 
+    cg3::Segment2d orderSegment(const cg3::Segment2d& segment);
+    bool canInsertOrderedSegment(const cg3::Segment2d& orderedSegment);
+    size_t insertOrderedSegment(const cg3::Segment2d& orderedSegment);
+
     std::vector<cg3::Point2d> points;
     std::vector<IndexedSegment2d> indexedSegments;
 
@@ -0,0 +1,147 @@
+#include "trapezoidalmap_faces.h"
+
+namespace {
+    /**
+     * @brief Finds the representative of the group of an element, halving the path to it
+     * @param parents, the parent of each element
+     * @param element, the element
+     * @return the representative
+     */
+    size_t findRoot(std::vector<size_t>& parents, size_t element) {
+        while(parents[element] != element) {
+            parents[element] = parents[parents[element]];
+            element = parents[element];
+        }
+        return element;
+    }
+
+    /**
+     * @brief Computes the y coordinate of a Segment (from left to right) at a given x inside its range
+     */
+    inline double yAt(const cg3::Segment2d& segment, const double& x) {
+        if(segment.p1().x() == segment.p2().x())
+            return segment.p1().y();
+        return segment.p1().y() + (x - segment.p1().x()) * (segment.p2().y() - segment.p1().y()) / (segment.p2().x() - segment.p1().x());
+    }
+}
+
+/**
+ * @brief TrapezoidalMapFaces Constructor, without any face
+ */
+TrapezoidalMapFaces::TrapezoidalMapFaces() : outerFace(SIZE_MAX) { }
+
+/**
+ * @brief TrapezoidalMapFaces Constructor, labels the Trapezoids of a built map
+ * @param tm, the TrapezoidalMap
+ */
+TrapezoidalMapFaces::TrapezoidalMapFaces(const TrapezoidalMap& tm) {
+    build(tm);
+}
+
+/**
+ * @brief Groups the Trapezoids of a map into faces and computes the area and the number of Trapezoids of each face
+ * @param tm, the TrapezoidalMap
+ */
+void TrapezoidalMapFaces::build(const TrapezoidalMap& tm) {
+    size_t size = tm.getTrapezoidalMapSize();
+
+    /* Union-find over the neighbors, the smaller index becomes the representative */
+    std::vector<size_t> parents(size);
+    for(size_t i = 0; i < size; i++)
+        parents[i] = i;
+
+    for(size_t i = 0; i < size; i++) {
+        if(tm.isFreeSlot(i))
+            continue;
+
+        /* The left neighbors are enough: every link is seen from the Trapezoid on its right */
+        const Trapezoid& trapezoid = tm.getTrapezoid(i);
+        for(const size_t& neighbor : {trapezoid.getTopLeftNeighbor(), trapezoid.getBotLeftNeighbor()}) {
+            if(neighbor == SIZE_MAX)
+                continue;
+
+            size_t a = findRoot(parents, i);
+            size_t b = findRoot(parents, neighbor);
+            if(a < b)
+                parents[b] = a;
+            else if(b < a)
+                parents[a] = b;
+        }
+    }
+
+    /* Numbering the faces in order of their first Trapezoid */
+    faceIds.assign(size, NO_STORED_INDEX);
+    faces.clear();
+    outerFace = SIZE_MAX;
+    for(size_t i = 0; i < size; i++) {
+        if(tm.isFreeSlot(i))
+            continue;
+
+        size_t root = findRoot(parents, i);
+        if(faceIds[root] == NO_STORED_INDEX) {
+            faceIds[root] = toStoredIndex(faces.size());
+            faces.push_back(FaceStatistics());
+        }
+        faceIds[i] = faceIds[root];
+
+        const Trapezoid& trapezoid = tm.getTrapezoid(i);
+        double left = tm.getLeftP(trapezoid).x();
+        double right = tm.getRightP(trapezoid).x();
+        const cg3::Segment2d& top = tm.getTop(trapezoid);
+        const cg3::Segment2d& bot = tm.getBot(trapezoid);
+
+        FaceStatistics& face = faces[faceIds[i]];
+        face.area += (right - left) * ((yAt(top, left) - yAt(bot, left)) + (yAt(top, right) - yAt(bot, right))) / 2;
+        face.trapezoids++;
+
+        /* The first two Segments are the bounding box */
+        if(trapezoid.getTopId() == 0 || trapezoid.getBotId() == 1)
+            outerFace = faceIds[i];
+    }
+}
+
+/**
+ * @brief Returns the face of a Trapezoid
+ * @param trapezoid, the index of the Trapezoid, a live one
+ * @return the id of the face
+ */
+size_t TrapezoidalMapFaces::getFaceId(const size_t& trapezoid) const {
+    assert(trapezoid < faceIds.size() && faceIds[trapezoid] != NO_STORED_INDEX);
+    return fromStoredIndex(faceIds[trapezoid]);
+}
+
+/**
+ * @brief Finds the face containing a given Point
+ * @param dag, the DAG of the labelled map
+ * @param point, the Point
+ * @return the id of the face
+ */
+size_t TrapezoidalMapFaces::findFace(const DAG& dag, const cg3::Point2d& point) const {
+    return getFaceId(dag.findPoint(point, point));
+}
+
+/**
+ * @brief Returns the number of faces
+ * @return the number of faces
+ */
+size_t TrapezoidalMapFaces::getFaceCount() const {
+    return faces.size();
+}
+
+/**
+ * @brief Returns the outer face, the one touching the bounding box
+ * @return the id of the outer face
+ */
+size_t TrapezoidalMapFaces::getOuterFace() const {
+    return outerFace;
+}
+
+/**
+ * @brief Returns the area and the number of Trapezoids of a face
+ * @param face, the id of the face
+ * @return the statistics of the face
+ */
+const TrapezoidalMapFaces::FaceStatistics& TrapezoidalMapFaces::getFaceStatistics(const size_t& face) const {
+    assert(face < faces.size());
+    return faces[face];
+}
@@ -0,0 +1,40 @@
+#ifndef TRAPEZOIDALMAP_FACES_H
+#define TRAPEZOIDALMAP_FACES_H
+
+#include "dag.h"
+
+/**
+ * @brief The TrapezoidalMapFaces class.
+ * Labels the Trapezoids of a built map with the face of the planar subdivision (e.g. a parcel or a zone)
+ * they belong to, so that the face containing a Point costs a DAG::findPoint and the read of an array.
+ * Two Trapezoids sharing a vertical side are never separated by a Segment: the faces are the groups
+ * of Trapezoids connected through the neighbors, found with a union-find.
+ * The faces are numbered from 0, the outer face is the one touching the bounding box.
+ * The labels have to be built again after the map changes.
+ */
+class TrapezoidalMapFaces {
+    public:
+        struct FaceStatistics {
+            double area;
+            size_t trapezoids;
+        };
+
+        TrapezoidalMapFaces();
+        TrapezoidalMapFaces(const TrapezoidalMap& tm);
+
+        void build(const TrapezoidalMap& tm);
+
+        size_t getFaceId(const size_t& trapezoid) const;
+        size_t findFace(const DAG& dag, const cg3::Point2d& point) const;
+
+        size_t getFaceCount() const;
+        size_t getOuterFace() const;
+        const FaceStatistics& getFaceStatistics(const size_t& face) const;
+    private:
+        /* Face of each Trapezoid, NO_STORED_INDEX for the free slots */
+        std::vector<StoredIndex> faceIds;
+        std::vector<FaceStatistics> faces;
+        size_t outerFace;
+};
+
+#endif // TRAPEZOIDALMAP_FACES_H
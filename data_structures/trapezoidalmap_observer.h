@@ -0,0 +1,47 @@
+#ifndef TRAPEZOIDALMAP_OBSERVER_H
+#define TRAPEZOIDALMAP_OBSERVER_H
+
+#include <cstddef>
+
+/**
+ * @brief The TrapezoidalMapObserver interface.
+ * It is notified by a TrapezoidalMap whenever its Trapezoids change,
+ * so that additional data (e.g. the drawing of the map) can be kept in sync
+ * without being part of the map itself.
+ */
+class TrapezoidalMapObserver {
+    public:
+        virtual ~TrapezoidalMapObserver() {}
+
+        /**
+         * @brief Called when a Trapezoid is added or its boundaries change.
+         * @param index, index of the Trapezoid
+         */
+        virtual void trapezoidUpdated(const size_t& index) = 0;
+
+        /**
+         * @brief Called when a Trapezoid becomes a free slot.
+         * @param index, index of the Trapezoid
+         */
+        virtual void trapezoidFreed(const size_t& index) = 0;
+
+        /**
+         * @brief Called when a free slot is removed from the map.
+         * @param index, index of the removed free slot
+         * @param moved, previous index of the Trapezoid moved in its place, SIZE_MAX if no Trapezoid has been moved
+         */
+        virtual void trapezoidRemoved(const size_t& index, const size_t& moved) = 0;
+
+        /**
+         * @brief Called when the map reserves space for a given number of Trapezoids.
+         * @param size, the number of Trapezoids
+         */
+        virtual void mapReserved(const size_t& size) = 0;
+
+        /**
+         * @brief Called after the map has been cleared, when it contains only the bounding box.
+         */
+        virtual void mapCleared() = 0;
+};
+
+#endif // TRAPEZOIDALMAP_OBSERVER_H
@@ -0,0 +1,283 @@
+#include "trapezoidalmap_snapshot.h"
+
+#include <cstring>
+#include <fstream>
+
+/* Identifies the snapshot files */
+static const char SNAPSHOT_MAGIC[8] = {'T', 'M', 'A', 'P', 'S', 'N', 'A', 'P'};
+
+/* Written in the byte order of the machine, to recognize files written with a different one */
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304u;
+
+/* Alignment of every table inside the file */
+static const uint64_t SNAPSHOT_ALIGNMENT = 8;
+
+/**
+ * @brief Rounds an offset up to the alignment of the tables
+ */
+static uint64_t alignOffset(const uint64_t& offset) {
+    return (offset + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+}
+
+/**
+ * @brief Writes a table to the file, preceded by the padding needed to reach its offset
+ */
+static void writeTable(std::ofstream& outfile, uint64_t& position, const uint64_t& offset,
+                       const void* table, const uint64_t& bytes) {
+    static const char padding[SNAPSHOT_ALIGNMENT] = {};
+    outfile.write(padding, static_cast<std::streamsize>(offset - position));
+    if(bytes > 0)
+        outfile.write(static_cast<const char*>(table), static_cast<std::streamsize>(bytes));
+    position = offset + bytes;
+}
+
+/**
+ * @brief Checks that a table lies inside the file and is aligned
+ */
+static bool checkTable(const uint64_t& offset, const uint64_t& count, const uint64_t& elementSize,
+                       const size_t& fileSize) {
+    return offset % SNAPSHOT_ALIGNMENT == 0 &&
+           offset <= fileSize &&
+           count <= (fileSize - offset) / elementSize;
+}
+
+/**
+ * @brief Checks that a child of a CompactDAG node refers to an existing node or Trapezoid
+ */
+static bool checkChild(const uint32_t& child, const uint64_t& nodeCount, const uint64_t& trapezoidCount) {
+    if(child & CompactDAG::LEAF_FLAG)
+        return (child & ~CompactDAG::LEAF_FLAG) < trapezoidCount;
+    return child < nodeCount;
+}
+
+/**
+ * @brief Checks that every index stored inside the tables of a snapshot refers to an existing element:
+ * the children and the values of the CompactDAG nodes and the neighbors of the Trapezoids
+ */
+static bool checkIndexes(const CompactDAG::Node* nodes, const uint64_t& nodeCount,
+                         const uint64_t& pointXCount, const uint64_t& segmentCount,
+                         const TrapezoidalMapSnapshot::TrapezoidRecord* trapezoids, const uint64_t& trapezoidCount) {
+    for(uint64_t i=0; i<nodeCount; i++) {
+        const CompactDAG::Node& node = nodes[i];
+        if(node.type == CompactDAG::pointNode) {
+            if(node.value >= pointXCount)
+                return false;
+        }
+        else if(node.type == CompactDAG::segmentNode) {
+            if(node.value >= segmentCount)
+                return false;
+        }
+        else {
+            return false;
+        }
+
+        if(!checkChild(node.left, nodeCount, trapezoidCount) || !checkChild(node.right, nodeCount, trapezoidCount))
+            return false;
+    }
+
+    for(uint64_t i=0; i<trapezoidCount; i++) {
+        const TrapezoidalMapSnapshot::TrapezoidRecord& trapezoid = trapezoids[i];
+        for(size_t j=0; j<4; j++) {
+            if(trapezoid.neighbors[j] != UINT32_MAX && trapezoid.neighbors[j] >= trapezoidCount)
+                return false;
+        }
+        if(trapezoid.freeSlot > 1)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief TrapezoidalMapSnapshot Constructor, no snapshot is loaded
+ */
+TrapezoidalMapSnapshot::TrapezoidalMapSnapshot() {
+    trapezoids = nullptr;
+    trapezoidCount = 0;
+}
+
+/**
+ * @brief Saves a built TrapezoidalMap and its DAG in a snapshot file.
+ *
+ * The indexes of the Trapezoids are preserved, "deleted" Trapezoids included.
+ * @param filename, the name of the file
+ * @param tm, the Trapezoidal Map
+ * @param dag, the DAG
+ * @return true if the file has been written
+ */
+bool TrapezoidalMapSnapshot::save(const std::string& filename, const TrapezoidalMap& tm, const DAG& dag) {
+    assert(tm.getTrapezoidalMapSize() < UINT32_MAX);
+
+    CompactDAG compactDAG(dag);
+
+    std::vector<TrapezoidRecord> records(tm.getTrapezoidalMapSize());
+    for(size_t i=0; i<records.size(); i++) {
+        const Trapezoid& t = tm.getTrapezoid(i);
+        TrapezoidRecord& r = records[i];
+
+        const cg3::Segment2d& top = tm.getTop(t);
+        const cg3::Segment2d& bot = tm.getBot(t);
+        const cg3::Point2d& leftP = tm.getLeftP(t);
+        const cg3::Point2d& rightP = tm.getRightP(t);
+
+        r.top[0] = top.p1().x(); r.top[1] = top.p1().y();
+        r.top[2] = top.p2().x(); r.top[3] = top.p2().y();
+        r.bot[0] = bot.p1().x(); r.bot[1] = bot.p1().y();
+        r.bot[2] = bot.p2().x(); r.bot[3] = bot.p2().y();
+        r.leftP[0] = leftP.x(); r.leftP[1] = leftP.y();
+        r.rightP[0] = rightP.x(); r.rightP[1] = rightP.y();
+
+        size_t neighbors[4] = {t.getTopLeftNeighbor(), t.getTopRightNeighbor(),
+                               t.getBotLeftNeighbor(), t.getBotRightNeighbor()};
+        for(size_t j=0; j<4; j++)
+            r.neighbors[j] = neighbors[j] == SIZE_MAX ? UINT32_MAX : static_cast<uint32_t>(neighbors[j]);
+
+        r.freeSlot = tm.isFreeSlot(i) ? 1 : 0;
+        r.padding = 0;
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.root = compactDAG.getRoot();
+
+    header.nodeCount = compactDAG.getNodeCount();
+    header.nodeOffset = alignOffset(sizeof(Header));
+    header.pointXCount = compactDAG.getPointXCount();
+    header.pointXOffset = alignOffset(header.nodeOffset + header.nodeCount * sizeof(CompactDAG::Node));
+    header.segmentCount = compactDAG.getSegmentCount();
+    header.segmentOffset = alignOffset(header.pointXOffset + header.pointXCount * sizeof(double));
+    header.trapezoidCount = records.size();
+    header.trapezoidOffset = alignOffset(header.segmentOffset + header.segmentCount * sizeof(CompactDAG::Segment));
+
+    std::ofstream outfile(filename, std::ios::binary);
+    if(!outfile)
+        return false;
+
+    uint64_t position = 0;
+    writeTable(outfile, position, 0, &header, sizeof(Header));
+    writeTable(outfile, position, header.nodeOffset,
+               compactDAG.getNodes(), header.nodeCount * sizeof(CompactDAG::Node));
+    writeTable(outfile, position, header.pointXOffset,
+               compactDAG.getPointXs(), header.pointXCount * sizeof(double));
+    writeTable(outfile, position, header.segmentOffset,
+               compactDAG.getSegments(), header.segmentCount * sizeof(CompactDAG::Segment));
+    writeTable(outfile, position, header.trapezoidOffset,
+               records.data(), header.trapezoidCount * sizeof(TrapezoidRecord));
+
+    outfile.close();
+    return !outfile.fail();
+}
+
+/**
+ * @brief Loads a snapshot file, mapping it in memory.
+ *
+ * The header is checked, then every index stored inside the tables (the children and the values
+ * of the nodes, the neighbors of the Trapezoids) is checked to be in range, so that a corrupted file
+ * cannot make a query read outside of the mapped memory. This costs a single pass over the file.
+ * @param filename, the name of the file
+ * @return true if the snapshot has been loaded, false if the file cannot be opened,
+ * it is not a snapshot of this version or it is corrupted
+ */
+bool TrapezoidalMapSnapshot::load(const std::string& filename) {
+    close();
+
+    if(!file.open(filename))
+        return false;
+
+    if(file.getSize() < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(file.getData());
+    const char* data = file.getData();
+    size_t size = file.getSize();
+
+    if(std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+       header->version != VERSION ||
+       header->byteOrder != SNAPSHOT_BYTE_ORDER ||
+       !checkTable(header->nodeOffset, header->nodeCount, sizeof(CompactDAG::Node), size) ||
+       !checkTable(header->pointXOffset, header->pointXCount, sizeof(double), size) ||
+       !checkTable(header->segmentOffset, header->segmentCount, sizeof(CompactDAG::Segment), size) ||
+       !checkTable(header->trapezoidOffset, header->trapezoidCount, sizeof(TrapezoidRecord), size) ||
+       header->trapezoidCount == 0 ||
+       header->nodeCount >= CompactDAG::LEAF_FLAG ||
+       !checkChild(header->root, header->nodeCount, header->trapezoidCount)) {
+        close();
+        return false;
+    }
+
+    const CompactDAG::Node* nodes = reinterpret_cast<const CompactDAG::Node*>(data + header->nodeOffset);
+    const TrapezoidRecord* records = reinterpret_cast<const TrapezoidRecord*>(data + header->trapezoidOffset);
+
+    if(!checkIndexes(nodes, header->nodeCount, header->pointXCount, header->segmentCount, records, header->trapezoidCount)) {
+        close();
+        return false;
+    }
+
+    dag = CompactDAG(header->root, nodes, header->nodeCount,
+                     reinterpret_cast<const double*>(data + header->pointXOffset), header->pointXCount,
+                     reinterpret_cast<const CompactDAG::Segment*>(data + header->segmentOffset), header->segmentCount);
+
+    trapezoids = records;
+    trapezoidCount = header->trapezoidCount;
+
+    return true;
+}
+
+/**
+ * @brief Releases the loaded snapshot
+ */
+void TrapezoidalMapSnapshot::close() {
+    dag.clear();
+    trapezoids = nullptr;
+    trapezoidCount = 0;
+    file.close();
+}
+
+/**
+ * @brief Tells if a snapshot is loaded
+ * @return true if a snapshot is loaded
+ */
+bool TrapezoidalMapSnapshot::isLoaded() const {
+    return trapezoids != nullptr;
+}
+
+/**
+ * @brief Finds the Trapezoid containing a given Point
+ * @param point, the Point
+ * @return returns the index of the Trapezoid containing the Point.
+ */
+size_t TrapezoidalMapSnapshot::findPoint(const cg3::Point2d& point) const {
+    assert(isLoaded());
+    return dag.findPoint(point, point);
+}
+
+/**
+ * @brief Getter for the CompactDAG of the snapshot, e.g. to locate batches of Points
+ * @return the CompactDAG, a view over the mapped file
+ */
+const CompactDAG& TrapezoidalMapSnapshot::getCompactDAG() const {
+    return dag;
+}
+
+/**
+ * @brief Returns the number of Trapezoid inside the snapshot, "deleted" ones included
+ * @return the number of Trapezoid
+ */
+size_t TrapezoidalMapSnapshot::getTrapezoidCount() const {
+    return trapezoidCount;
+}
+
+/**
+ * @brief Returns the record of the Trapezoid located in the index position, as it is stored in the file
+ * @param index, index of the Trapezoid
+ * @return the record of the Trapezoid
+ */
+const TrapezoidalMapSnapshot::TrapezoidRecord& TrapezoidalMapSnapshot::getTrapezoidRecord(const size_t& index) const {
+    assert(index < trapezoidCount);
+    return trapezoids[index];
+}
@@ -0,0 +1,66 @@
+#ifndef TRAPEZOIDALMAP_SNAPSHOT_H
+#define TRAPEZOIDALMAP_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+
+#include "compact_dag.h"
+#include "utils/mappedfile.h"
+
+/**
+ * @brief The TrapezoidalMapSnapshot class.
+ * A built TrapezoidalMap and its DAG saved in a binary file, ready to answer queries.
+ * The file is made of a header followed by the tables of a CompactDAG and by the Trapezoids,
+ * all referring to each other through indexes and offsets, so that it can be
+ * memory mapped and used as it is, without parsing nor allocating anything
+ * (the indexes are only checked once, when the file is loaded).
+ * The file uses the byte order of the machine that wrote it, a different one is rejected.
+ */
+class TrapezoidalMapSnapshot {
+    public:
+        static const uint32_t VERSION = 1;
+
+        struct TrapezoidRecord {
+            double top[4];
+            double bot[4];
+            double leftP[2];
+            double rightP[2];
+            /* topLeft, topRight, botLeft, botRight, UINT32_MAX if missing */
+            uint32_t neighbors[4];
+            uint32_t freeSlot;
+            uint32_t padding;
+        };
+
+        TrapezoidalMapSnapshot();
+
+        static bool save(const std::string& filename, const TrapezoidalMap& tm, const DAG& dag);
+
+        bool load(const std::string& filename);
+        void close();
+        bool isLoaded() const;
+
+        size_t findPoint(const cg3::Point2d& point) const;
+        const CompactDAG& getCompactDAG() const;
+
+        size_t getTrapezoidCount() const;
+        const TrapezoidRecord& getTrapezoidRecord(const size_t& index) const;
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t byteOrder;
+            uint32_t root;
+            uint32_t reserved;
+            uint64_t nodeCount, nodeOffset;
+            uint64_t pointXCount, pointXOffset;
+            uint64_t segmentCount, segmentOffset;
+            uint64_t trapezoidCount, trapezoidOffset;
+        };
+
+        MappedFile file;
+        CompactDAG dag;
+        const TrapezoidRecord* trapezoids;
+        size_t trapezoidCount;
+};
+
+#endif // TRAPEZOIDALMAP_SNAPSHOT_H
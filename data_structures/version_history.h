@@ -0,0 +1,136 @@
+#ifndef VERSION_HISTORY_H
+#define VERSION_HISTORY_H
+
+#include <vector>
+
+#include "stored_index.h"
+
+/**
+ * @brief The VersionHistory class.
+ * Keeps the previous values of the elements of a vector that is updated in place,
+ * so that the vector can be read as it was at any past version ("fat nodes").
+ *
+ * The vector is at version 0 when the history is enabled or cleared, every commit creates a new version.
+ * Only the first overwrite of an element in each version is saved, the elements added
+ * after the last commit are not saved at all: the space used is O(1) for every change.
+ * Until the first commit, the elements added still belong to the version 0
+ * (e.g. the root added to a cleared DAG).
+ * The elements are never removed from the vector while the history is enabled.
+ */
+template <class T>
+class VersionHistory {
+    private:
+        struct Change {
+            /* The value the element had before it was overwritten */
+            T value;
+            /* The first version in which the element does not have that value anymore */
+            size_t version;
+            /* The previous change of the same element, NO_STORED_INDEX if there is none */
+            StoredIndex previous;
+        };
+
+        bool enabled;
+        size_t version;
+        /* Number of elements of the vector at the last commit, SIZE_MAX before the first one */
+        size_t committedSize;
+
+        std::vector<Change> changes;
+        /* Last change of each element, shorter than the vector if the last elements never changed */
+        std::vector<StoredIndex> lastChange;
+    public:
+        VersionHistory() : enabled(false), version(0), committedSize(SIZE_MAX) {}
+
+        /**
+         * @brief Tells if the previous values are being kept
+         * @return true if the history is enabled
+         */
+        bool isEnabled() const { return enabled; }
+
+        /**
+         * @brief Returns the last committed version, the changes not committed yet will belong to the next one
+         * @return the number of commits
+         */
+        size_t getVersion() const { return version; }
+
+        /**
+         * @brief Enables or disables the history, dropping the saved values.
+         * If enabled, the current content of the vector becomes the version 0.
+         * @param enabled, true to keep the previous values
+         */
+        void setEnabled(const bool& enabled) {
+            this->enabled = enabled;
+            clear();
+        }
+
+        /**
+         * @brief Drops the saved values, the current content of the vector becomes the version 0
+         */
+        void clear() {
+            version = 0;
+            committedSize = SIZE_MAX;
+            changes.clear();
+            lastChange.clear();
+        }
+
+        /**
+         * @brief Saves the value of an element which is going to be overwritten
+         * @param index, index of the element
+         * @param value, its current value
+         */
+        void save(const size_t& index, const T& value) {
+            if(!enabled || index >= committedSize)
+                return;
+
+            if(lastChange.size() <= index)
+                lastChange.resize(index + 1, NO_STORED_INDEX);
+
+            StoredIndex last = lastChange[index];
+            if(last != NO_STORED_INDEX && changes[last].version == version + 1)
+                return;
+
+            Change change = {value, version + 1, last};
+            changes.push_back(change);
+            lastChange[index] = toStoredIndex(changes.size() - 1);
+        }
+
+        /**
+         * @brief Ends the current version, the next changes will belong to a new one
+         * @param size, the number of elements of the vector
+         * @return the number of the new version
+         */
+        size_t commit(const size_t& size) {
+            committedSize = size;
+            return ++version;
+        }
+
+        /**
+         * @brief Returns the value an element had at a given version.
+         * The element has to exist at that version.
+         * @param current, the vector
+         * @param index, index of the element
+         * @param at, the version, at most the current one
+         * @return the value of the element
+         */
+        const T& get(const std::vector<T>& current, const size_t& index, const size_t& at) const {
+            assert(index < current.size() && at <= version);
+
+            if(index >= lastChange.size())
+                return current[index];
+
+            const T* value = &current[index];
+            StoredIndex c = lastChange[index];
+            while(c != NO_STORED_INDEX && changes[c].version > at) {
+                value = &changes[c].value;
+                c = changes[c].previous;
+            }
+            return *value;
+        }
+
+        /**
+         * @brief Returns the number of saved values
+         * @return the number of saved values
+         */
+        size_t getChangeCount() const { return changes.size(); }
+};
+
+#endif // VERSION_HISTORY_H
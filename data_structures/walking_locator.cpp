@@ -0,0 +1,232 @@
+#include "walking_locator.h"
+
+#include <algorithm>
+
+#include "utils/utils.h"
+
+namespace {
+    /**
+     * @brief Computes the orientation of a Point with respect to the line through a Segment
+     * @return a positive value if the Point is above the line, a negative value if it is below, zero if it is on it
+     */
+    inline double orientation(const cg3::Segment2d& segment, const cg3::Point2d& point) {
+        return Utils::orientation(segment.p1().x(), segment.p1().y(), segment.p2().x(), segment.p2().y(),
+                                  point.x(), point.y());
+    }
+
+    /**
+     * @brief Chooses between the two neighbors on the same side of a Trapezoid.
+     * The top neighbor shares the top Segment of the Trapezoid and the bot neighbor shares the bot one:
+     * when they are different they are separated by a Segment ending on the vertical side,
+     * the bot Segment of the top neighbor.
+     * @param preferTop, true to take the top neighbor when the Point does not decide (e.g. when walking around a Segment)
+     * @return the index of the chosen neighbor, SIZE_MAX if there is none
+     */
+    inline size_t chooseNeighbor(const TrapezoidalMap& tm, const size_t& topNeighbor, const size_t& botNeighbor,
+                                 const cg3::Point2d& point, const bool* preferTop) {
+        if(topNeighbor == SIZE_MAX)
+            return botNeighbor;
+        if(botNeighbor == SIZE_MAX || botNeighbor == topNeighbor)
+            return topNeighbor;
+
+        if(preferTop != nullptr)
+            return *preferTop ? topNeighbor : botNeighbor;
+        return orientation(tm.getBot(topNeighbor), point) > 0 ? topNeighbor : botNeighbor;
+    }
+}
+
+/**
+ * @brief WalkingLocator Constructor
+ * @param dag, the DAG of the map, used when the walks fail
+ * @param tm, the TrapezoidalMap, whose bounding box is covered by the query cache
+ * @param stepBudget, the maximum number of steps of a walk
+ * @param cacheResolution, the number of cells of the query cache on each side of the bounding box
+ */
+WalkingLocator::WalkingLocator(const DAG& dag, const TrapezoidalMap& tm,
+                               const size_t& stepBudget, const size_t& cacheResolution) :
+    dag(dag), tm(tm), stepBudget(stepBudget), cacheResolution(std::max(cacheResolution, size_t(1)))
+{
+    const Trapezoid& boundingBox = tm.getBoundingBox();
+    minX = tm.getLeftP(boundingBox).x();
+    minY = tm.getBot(boundingBox).p1().y();
+    cellWidth = (tm.getRightP(boundingBox).x() - minX) / this->cacheResolution;
+    cellHeight = (tm.getTop(boundingBox).p1().y() - minY) / this->cacheResolution;
+
+    reset();
+}
+
+/**
+ * @brief Finds the Trapezoid containing a given Point.
+ * The Point is searched walking from the previous answer, then from the one cached for its cell,
+ * and at last through the DAG.
+ * @param point, the Point
+ * @return returns the index (inside the TrapezoidalMap) of the Trapezoid containing the Point,
+ * the same one returned by DAG::findPoint
+ */
+size_t WalkingLocator::findPoint(const cg3::Point2d& point) {
+    statistics.queries++;
+
+    size_t found = SIZE_MAX;
+    size_t steps;
+
+    if(isValidStart(last)) {
+        found = walk(point, last, steps);
+        statistics.steps += steps;
+    }
+
+    size_t pointCell = cell(point);
+    size_t cached = cache[pointCell];
+    if(found == SIZE_MAX && cached != last && isValidStart(cached)) {
+        found = walk(point, cached, steps);
+        statistics.steps += steps;
+    }
+
+    if(found != SIZE_MAX) {
+        statistics.walks++;
+    }
+    else {
+        found = dag.findPoint(point, point);
+        statistics.fallbacks++;
+    }
+
+    last = found;
+    cache[pointCell] = found;
+    return found;
+}
+
+/**
+ * @brief Walks from a Trapezoid to the one containing a given Point strictly inside.
+ *
+ * A step moves to a neighbor on the left (or on the right) of the Trapezoid while the Point
+ * lies on that side of it. When the Point lies above the top Segment (or below the bot one)
+ * the walk goes around that Segment, moving along the Trapezoids below it (or above it)
+ * towards its nearest endpoint.
+ * @param point, the Point
+ * @param start, the index of the first Trapezoid, it has to be a live one
+ * @param steps, the number of steps done
+ * @return returns the index of the Trapezoid containing the Point, SIZE_MAX if it has not been reached
+ * within the step budget or if the Point lies on a boundary
+ */
+size_t WalkingLocator::walk(const cg3::Point2d& point, const size_t& start, size_t& steps) const {
+    size_t current = start;
+
+    /* The Segment the walk is going around, SIZE_MAX if there is none */
+    size_t around = SIZE_MAX;
+    bool aroundTop = false;
+    bool leftwards = false;
+
+    for(steps = 0; ; steps++) {
+        const Trapezoid& trapezoid = tm.getTrapezoid(current);
+
+        if(around != SIZE_MAX && (aroundTop ? trapezoid.getTopId() : trapezoid.getBotId()) != around)
+            around = SIZE_MAX;
+
+        bool left;
+        if(around != SIZE_MAX) {
+            left = leftwards;
+        }
+        else {
+            double leftX = tm.getLeftP(trapezoid).x();
+            double rightX = tm.getRightP(trapezoid).x();
+
+            if(point.x() == leftX || point.x() == rightX)
+                return SIZE_MAX;
+
+            if(point.x() < leftX) {
+                left = true;
+            }
+            else if(point.x() > rightX) {
+                left = false;
+            }
+            else {
+                const cg3::Segment2d& top = tm.getTop(trapezoid);
+                const cg3::Segment2d& bot = tm.getBot(trapezoid);
+                double topOrientation = orientation(top, point);
+                double botOrientation = orientation(bot, point);
+
+                if(topOrientation == 0 || botOrientation == 0)
+                    return SIZE_MAX;
+                if(topOrientation < 0 && botOrientation > 0)
+                    return current;
+
+                /* Above the top Segment or below the bot one */
+                aroundTop = topOrientation > 0;
+                around = aroundTop ? trapezoid.getTopId() : trapezoid.getBotId();
+                const cg3::Segment2d& segment = aroundTop ? top : bot;
+                leftwards = point.x() - segment.p1().x() < segment.p2().x() - point.x();
+                left = leftwards;
+            }
+        }
+
+        if(steps == stepBudget)
+            return SIZE_MAX;
+
+        /* While going around a Segment, the walk stays on its side */
+        const bool* preferTop = around != SIZE_MAX ? &aroundTop : nullptr;
+        if(left)
+            current = chooseNeighbor(tm, trapezoid.getTopLeftNeighbor(), trapezoid.getBotLeftNeighbor(), point, preferTop);
+        else
+            current = chooseNeighbor(tm, trapezoid.getTopRightNeighbor(), trapezoid.getBotRightNeighbor(), point, preferTop);
+
+        if(current == SIZE_MAX)
+            return SIZE_MAX;
+    }
+}
+
+/**
+ * @brief Forgets the previous answer and empties the query cache
+ */
+void WalkingLocator::reset() {
+    last = SIZE_MAX;
+    cache.assign(cacheResolution * cacheResolution, SIZE_MAX);
+    statistics = Statistics();
+}
+
+/**
+ * @brief Getter for the maximum number of steps of a walk
+ * @return the step budget
+ */
+size_t WalkingLocator::getStepBudget() const {
+    return stepBudget;
+}
+
+/**
+ * @brief Sets the maximum number of steps of a walk, 0 to always answer through the DAG
+ * @param stepBudget, the step budget
+ */
+void WalkingLocator::setStepBudget(const size_t& stepBudget) {
+    this->stepBudget = stepBudget;
+}
+
+/**
+ * @brief Returns how the queries have been answered since the last reset
+ * @return the statistics
+ */
+const WalkingLocator::Statistics& WalkingLocator::getStatistics() const {
+    return statistics;
+}
+
+/**
+ * @brief Returns the cell of the query cache containing a Point, the Points outside of the bounding box
+ * are assigned to the nearest cell
+ * @param point, the Point
+ * @return the index of the cell
+ */
+size_t WalkingLocator::cell(const cg3::Point2d& point) const {
+    double column = (point.x() - minX) / cellWidth;
+    double row = (point.y() - minY) / cellHeight;
+    size_t maxCell = cacheResolution - 1;
+
+    size_t x = column > 0 ? std::min(static_cast<size_t>(column), maxCell) : 0;
+    size_t y = row > 0 ? std::min(static_cast<size_t>(row), maxCell) : 0;
+    return y * cacheResolution + x;
+}
+
+/**
+ * @brief Tells if a Trapezoid can be the start of a walk, that is if it is still inside the map
+ * @param index, the index of the Trapezoid, SIZE_MAX if there is none
+ * @return true if the Trapezoid is a live one
+ */
+bool WalkingLocator::isValidStart(const size_t& index) const {
+    return index < tm.getTrapezoidalMapSize() && !tm.isFreeSlot(index);
+}
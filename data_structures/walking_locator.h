@@ -0,0 +1,66 @@
+#ifndef WALKING_LOCATOR_H
+#define WALKING_LOCATOR_H
+
+#include "dag.h"
+
+/**
+ * @brief The WalkingLocator class.
+ * Answers a stream of point location queries starting from the answer of the previous query
+ * and walking through the neighbors of the Trapezoids, instead of starting every time from the root of the DAG.
+ * When the walk does not reach the Point within a budget of steps, it is tried again from the Trapezoid
+ * found last time inside the same cell of a grid laid over the bounding box (the query cache),
+ * and then the query is answered by the DAG.
+ * On spatially coherent streams (e.g. the positions of the mouse or a GPS trace) most queries take
+ * a constant number of steps.
+ *
+ * A walk only stops inside a Trapezoid containing the Point strictly inside, so the answers
+ * are the same ones of DAG::findPoint. The Points lying on a boundary are always answered by the DAG.
+ * The locator keeps the state of a single stream: it is not meant to be shared between threads.
+ * It can be used while the map changes: the Trapezoids it remembers are only used as starting points.
+ */
+class WalkingLocator {
+    public:
+        struct Statistics {
+            /* Number of queries */
+            size_t queries;
+            /* Number of queries answered by a walk */
+            size_t walks;
+            /* Number of queries answered by the DAG */
+            size_t fallbacks;
+            /* Total number of steps of the walks, failed ones included */
+            size_t steps;
+        };
+
+        WalkingLocator(const DAG& dag, const TrapezoidalMap& tm,
+                       const size_t& stepBudget = 16, const size_t& cacheResolution = 64);
+
+        size_t findPoint(const cg3::Point2d& point);
+        size_t walk(const cg3::Point2d& point, const size_t& start, size_t& steps) const;
+
+        void reset();
+
+        size_t getStepBudget() const;
+        void setStepBudget(const size_t& stepBudget);
+        const Statistics& getStatistics() const;
+    private:
+        const DAG& dag;
+        const TrapezoidalMap& tm;
+
+        size_t stepBudget;
+
+        /* Answer of the previous query, SIZE_MAX if there is none */
+        size_t last;
+
+        /* Query cache: the last answer found inside each cell of a cacheResolution x cacheResolution grid */
+        std::vector<size_t> cache;
+        size_t cacheResolution;
+        double minX, minY;
+        double cellWidth, cellHeight;
+
+        Statistics statistics;
+
+        size_t cell(const cg3::Point2d& point) const;
+        bool isValidStart(const size_t& index) const;
+};
+
+#endif // WALKING_LOCATOR_H
@@ -16,7 +16,7 @@ void DrawableTrapezoidalMapDataset::draw() const
     for (const cg3::Point2d& p : getPoints()) {
         cg3::opengl::drawPoint2(p, pointColor, static_cast<int>(pointSize));
     }
-    for (const cg3::Segment2d& seg : getSegments()) {
+    for (const cg3::Segment2d& seg : getSegmentRange()) {
         cg3::opengl::drawLine2(seg.p1(), seg.p2(), segmentColor, static_cast<int>(segmentSize));
     }
 }
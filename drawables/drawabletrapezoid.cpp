@@ -7,28 +7,34 @@
 
 /**
  * @brief DrawableTrapezoid constructor.
+ * @param tm, the TrapezoidalMap the Trapezoid belongs to, which holds its Segments and Points.
  * @param t, Trapezoid the DrawableTrapezoid is constructed from.
  */
-DrawableTrapezoid::DrawableTrapezoid(Trapezoid& t) {
-    if(t.getTop().p1() != t.getLeftP())
-        topLeft = calculateIntersection(t.getTop(), t.getLeftP().x());
+DrawableTrapezoid::DrawableTrapezoid(const TrapezoidalMap& tm, const Trapezoid& t) {
+    const cg3::Segment2d& top = tm.getTop(t);
+    const cg3::Segment2d& bot = tm.getBot(t);
+    const cg3::Point2d& leftP = tm.getLeftP(t);
+    const cg3::Point2d& rightP = tm.getRightP(t);
+
+    if(top.p1() != leftP)
+        topLeft = calculateIntersection(top, leftP.x());
     else
-        topLeft = t.getLeftP();
+        topLeft = leftP;
 
-    if(t.getTop().p2() != t.getRightP())
-        topRight = calculateIntersection(t.getTop(), t.getRightP().x());
+    if(top.p2() != rightP)
+        topRight = calculateIntersection(top, rightP.x());
     else
-        topRight = t.getRightP();
+        topRight = rightP;
 
-    if(t.getBot().p2() != t.getRightP())
-        botRight = calculateIntersection(t.getBot(), t.getRightP().x());
+    if(bot.p2() != rightP)
+        botRight = calculateIntersection(bot, rightP.x());
     else
-        botRight = t.getRightP();
+        botRight = rightP;
 
-    if(t.getBot().p1() != t.getLeftP())
-        botLeft = calculateIntersection(t.getBot(), t.getLeftP().x());
+    if(bot.p1() != leftP)
+        botLeft = calculateIntersection(bot, leftP.x());
     else
-        botLeft = t.getLeftP();
+        botLeft = leftP;
 
     color = randomColor();
 }
@@ -1,7 +1,7 @@
 #ifndef DRAWABLETRAPEZOID_H
 #define DRAWABLETRAPEZOID_H
 
-#include <data_structures/trapezoid.h>
+#include <data_structures/trapezoidalmap.h>
 #include <cg3/utilities/color.h>
 #include <cstdlib>
 #include <ctime>
@@ -23,7 +23,7 @@ class DrawableTrapezoid
         const cg3::Color randomColor() const;
         const cg3::Point2d calculateIntersection(const cg3::Segment2d& s, const double& x) const;
     public:
-        DrawableTrapezoid(Trapezoid& trapezoid);
+        DrawableTrapezoid(const TrapezoidalMap& tm, const Trapezoid& trapezoid);
 
         const cg3::Point2d& getTopLeft() const;
         const cg3::Point2d& getTopRight() const;
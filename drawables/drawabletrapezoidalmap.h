@@ -2,21 +2,31 @@
 #define DRAWABLETRAPEZOIDALMAP_H
 
 #include "data_structures/trapezoidalmap.h"
-#include "drawables/drawabletrapezoid.h"
+#include "data_structures/trapezoidalmap_observer.h"
+#include "drawables/trapezoidvertexupdater.h"
 #include <cg3/viewer/interfaces/drawable_object.h>
 #include <cg3/viewer/opengl_objects/opengl_objects2.h>
 #include <cg3/geometry/bounding_box2.h>
 
-class DrawableTrapezoidalMap : public TrapezoidalMap, public cg3::DrawableObject
+/**
+ * @brief The DrawableTrapezoidalMap class.
+ * A TrapezoidalMap observing itself to keep its drawing in sync,
+ * the algorithms only see the TrapezoidalMap.
+ * The vertex arrays are kept by a TrapezoidVertexUpdater, this class only adds the selection and the OpenGL calls.
+ */
+class DrawableTrapezoidalMap : public TrapezoidalMap, public TrapezoidalMapObserver, public cg3::DrawableObject
 {
     private:
-        std::vector<DrawableTrapezoid> drawableTrapezoids;
+        /* The geometry of the changed Trapezoids is computed only when the map is drawn */
+        mutable TrapezoidVertexUpdater updater;
         size_t selectedTrapezoid;
 
         const cg3::Color selectedTrapezoidColor;
         const cg3::Color segmentColor;
     public:
         DrawableTrapezoidalMap(const cg3::Point2d& botLeft, const cg3::Point2d& topRight);
+        DrawableTrapezoidalMap(const DrawableTrapezoidalMap& other) = delete;
+        DrawableTrapezoidalMap& operator=(const DrawableTrapezoidalMap& other) = delete;
 
         void draw() const;
         cg3::Point3d sceneCenter() const;
@@ -24,16 +34,11 @@ class DrawableTrapezoidalMap : public TrapezoidalMap, public cg3::DrawableObject
 
         void setSelectedTrapezoid(size_t index);
 
-        const std::array<size_t, 4> split4(const size_t& trpzToReplace, const cg3::Segment2d& segment);
-        const std::array<size_t, 3> split3L(const size_t& trpzToReplace, const cg3::Segment2d& segment);
-        const std::array<size_t, 2> split2(const size_t& trpzToReplace, const cg3::Segment2d& segment,
-                                         const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot);
-        const std::array<size_t, 3> split3R(const size_t& trpzToReplace, const cg3::Segment2d& segment,
-                                          const size_t& trpzPrevSplitTop, const size_t& trpzPrevSplitBot);
-
-        void merge(const size_t& leftTrpzIndex, const size_t& rightTrpzIndex);
-
-        void clear();
+        void trapezoidUpdated(const size_t& index);
+        void trapezoidFreed(const size_t& index);
+        void trapezoidRemoved(const size_t& index, const size_t& moved);
+        void mapReserved(const size_t& size);
+        void mapCleared();
 };
 
 #endif // DRAWABLETRAPEZOIDALMAP_H
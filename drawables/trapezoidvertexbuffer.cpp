@@ -0,0 +1,199 @@
+#include "trapezoidvertexbuffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+/* Number of components of each vertex and color */
+#define VERTEX_COMPONENTS 2
+#define COLOR_COMPONENTS 3
+
+/**
+ * @brief TrapezoidVertexBuffer constructor.
+ */
+TrapezoidVertexBuffer::TrapezoidVertexBuffer() {}
+
+/**
+ * @brief Makes sure the arrays have a range for the Trapezoid of the given index.
+ * The new ranges are degenerate.
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexBuffer::ensureSize(const size_t& index) {
+    if(index >= size())
+        resize(index+1);
+}
+
+/**
+ * @brief Writes a vertex of the fill and its color.
+ * @param vertex, index of the vertex inside the fill arrays
+ * @param p, position of the vertex
+ * @param color, color of the vertex
+ */
+void TrapezoidVertexBuffer::setFillVertex(const size_t& vertex, const cg3::Point2d& p, const cg3::Color& color) {
+    fillVertices[vertex*VERTEX_COMPONENTS] = p.x();
+    fillVertices[vertex*VERTEX_COMPONENTS+1] = p.y();
+
+    fillColors[vertex*COLOR_COMPONENTS] = static_cast<uint8_t>(color.red());
+    fillColors[vertex*COLOR_COMPONENTS+1] = static_cast<uint8_t>(color.green());
+    fillColors[vertex*COLOR_COMPONENTS+2] = static_cast<uint8_t>(color.blue());
+}
+
+/**
+ * @brief Writes a vertex of the boundaries.
+ * @param vertex, index of the vertex inside the boundary array
+ * @param p, position of the vertex
+ */
+void TrapezoidVertexBuffer::setBoundaryVertex(const size_t& vertex, const cg3::Point2d& p) {
+    boundaryVertices[vertex*VERTEX_COMPONENTS] = p.x();
+    boundaryVertices[vertex*VERTEX_COMPONENTS+1] = p.y();
+}
+
+/**
+ * @brief Writes the geometry and the color of a DrawableTrapezoid in its range.
+ *
+ * The fill is made of the triangles (p1, p2, p3) and (p1, p3, p4),
+ * one of them is degenerate when the Trapezoid is a Triangle.
+ *
+ * The vertical boundaries overlapping with the bounding box are not drawn.
+ * @param index, index of the Trapezoid
+ * @param trapezoid, its DrawableTrapezoid
+ * @param minX, x coordinate of the left boundary of the bounding box of the map
+ * @param maxX, x coordinate of the right boundary of the bounding box of the map
+ */
+void TrapezoidVertexBuffer::set(const size_t& index, const DrawableTrapezoid& trapezoid, const double& minX, const double& maxX) {
+    ensureSize(index);
+
+    /* References to the effective points of the Trapezoid */
+    const cg3::Point2d& p1 = trapezoid.getTopLeft();
+    const cg3::Point2d& p2 = trapezoid.getTopRight();
+    const cg3::Point2d& p3 = trapezoid.getBotRight();
+    const cg3::Point2d& p4 = trapezoid.getBotLeft();
+    const cg3::Color& color = trapezoid.getColor();
+
+    size_t fill = index * FILL_VERTICES;
+    setFillVertex(fill, p1, color);
+    setFillVertex(fill+1, p2, color);
+    setFillVertex(fill+2, p3, color);
+    setFillVertex(fill+3, p1, color);
+    setFillVertex(fill+4, p3, color);
+    setFillVertex(fill+5, p4, color);
+
+    size_t boundary = index * BOUNDARY_VERTICES;
+    bool leftBoundary = p1 != p4 && p1.x() != minX;
+    bool rightBoundary = p2 != p3 && p2.x() != maxX;
+
+    setBoundaryVertex(boundary, p1);
+    setBoundaryVertex(boundary+1, leftBoundary ? p4 : p1);
+    setBoundaryVertex(boundary+2, p2);
+    setBoundaryVertex(boundary+3, rightBoundary ? p3 : p2);
+}
+
+/**
+ * @brief Changes the fill color of a Trapezoid.
+ * @param index, index of the Trapezoid
+ * @param color, the new color
+ */
+void TrapezoidVertexBuffer::setColor(const size_t& index, const cg3::Color& color) {
+    assert(index < size());
+
+    for(size_t vertex = index * FILL_VERTICES; vertex < (index+1) * FILL_VERTICES; vertex++) {
+        fillColors[vertex*COLOR_COMPONENTS] = static_cast<uint8_t>(color.red());
+        fillColors[vertex*COLOR_COMPONENTS+1] = static_cast<uint8_t>(color.green());
+        fillColors[vertex*COLOR_COMPONENTS+2] = static_cast<uint8_t>(color.blue());
+    }
+}
+
+/**
+ * @brief Makes the range of a Trapezoid degenerate (e.g. after it has become a free slot).
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexBuffer::unset(const size_t& index) {
+    assert(index < size());
+
+    std::fill(fillVertices.begin() + index * FILL_VERTICES * VERTEX_COMPONENTS,
+              fillVertices.begin() + (index+1) * FILL_VERTICES * VERTEX_COMPONENTS, 0.0);
+    std::fill(boundaryVertices.begin() + index * BOUNDARY_VERTICES * VERTEX_COMPONENTS,
+              boundaryVertices.begin() + (index+1) * BOUNDARY_VERTICES * VERTEX_COMPONENTS, 0.0);
+}
+
+/**
+ * @brief Copies the range of a Trapezoid in the range of another one.
+ * @param from, index of the Trapezoid to copy
+ * @param to, index of the destination
+ */
+void TrapezoidVertexBuffer::move(const size_t& from, const size_t& to) {
+    assert(from < size() && to < size());
+
+    std::copy(fillVertices.begin() + from * FILL_VERTICES * VERTEX_COMPONENTS,
+              fillVertices.begin() + (from+1) * FILL_VERTICES * VERTEX_COMPONENTS,
+              fillVertices.begin() + to * FILL_VERTICES * VERTEX_COMPONENTS);
+    std::copy(fillColors.begin() + from * FILL_VERTICES * COLOR_COMPONENTS,
+              fillColors.begin() + (from+1) * FILL_VERTICES * COLOR_COMPONENTS,
+              fillColors.begin() + to * FILL_VERTICES * COLOR_COMPONENTS);
+    std::copy(boundaryVertices.begin() + from * BOUNDARY_VERTICES * VERTEX_COMPONENTS,
+              boundaryVertices.begin() + (from+1) * BOUNDARY_VERTICES * VERTEX_COMPONENTS,
+              boundaryVertices.begin() + to * BOUNDARY_VERTICES * VERTEX_COMPONENTS);
+}
+
+/**
+ * @brief Resizes the arrays to hold a given number of Trapezoids.
+ * The new ranges are degenerate.
+ * @param size, the number of Trapezoids
+ */
+void TrapezoidVertexBuffer::resize(const size_t& size) {
+    fillVertices.resize(size * FILL_VERTICES * VERTEX_COMPONENTS, 0.0);
+    fillColors.resize(size * FILL_VERTICES * COLOR_COMPONENTS, 0);
+    boundaryVertices.resize(size * BOUNDARY_VERTICES * VERTEX_COMPONENTS, 0.0);
+}
+
+/**
+ * @brief Returns the number of Trapezoids the arrays have a range for.
+ * @return the number of Trapezoids.
+ */
+size_t TrapezoidVertexBuffer::size() const {
+    return boundaryVertices.size() / (BOUNDARY_VERTICES * VERTEX_COMPONENTS);
+}
+
+/**
+ * @brief Getter for the fill vertices, two doubles for each vertex.
+ * @return a pointer to the first vertex.
+ */
+const double* TrapezoidVertexBuffer::getFillVertices() const { return fillVertices.data(); }
+/**
+ * @brief Getter for the fill colors, three bytes (RGB) for each vertex.
+ * @return a pointer to the first color.
+ */
+const uint8_t* TrapezoidVertexBuffer::getFillColors() const { return fillColors.data(); }
+/**
+ * @brief Getter for the number of fill vertices.
+ * @return the number of fill vertices.
+ */
+size_t TrapezoidVertexBuffer::getFillVertexCount() const { return size() * FILL_VERTICES; }
+/**
+ * @brief Getter for the boundary vertices, two doubles for each vertex.
+ * @return a pointer to the first vertex.
+ */
+const double* TrapezoidVertexBuffer::getBoundaryVertices() const { return boundaryVertices.data(); }
+/**
+ * @brief Getter for the number of boundary vertices.
+ * @return the number of boundary vertices.
+ */
+size_t TrapezoidVertexBuffer::getBoundaryVertexCount() const { return size() * BOUNDARY_VERTICES; }
+
+/**
+ * @brief Reserves space for a given number of Trapezoids.
+ * @param size, the number of Trapezoids to reserve space for
+ */
+void TrapezoidVertexBuffer::reserve(const size_t& size) {
+    fillVertices.reserve(size * FILL_VERTICES * VERTEX_COMPONENTS);
+    fillColors.reserve(size * FILL_VERTICES * COLOR_COMPONENTS);
+    boundaryVertices.reserve(size * BOUNDARY_VERTICES * VERTEX_COMPONENTS);
+}
+
+/**
+ * @brief Removes all the Trapezoids.
+ */
+void TrapezoidVertexBuffer::clear() {
+    fillVertices.clear();
+    fillColors.clear();
+    boundaryVertices.clear();
+}
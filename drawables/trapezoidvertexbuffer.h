@@ -0,0 +1,52 @@
+#ifndef TRAPEZOIDVERTEXBUFFER_H
+#define TRAPEZOIDVERTEXBUFFER_H
+
+#include "drawables/drawabletrapezoid.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The TrapezoidVertexBuffer class.
+ * Keeps the geometry of the DrawableTrapezoids in flat arrays, ready to be drawn with a couple of calls.
+ * Each Trapezoid owns a fixed range of the arrays (two triangles for the fill, two lines for its vertical boundaries),
+ * so that a change of a single Trapezoid only rewrites its own range.
+ * The unused ranges (free slots, triangles, hidden boundaries) are degenerate and do not produce any fragment.
+ * The coordinates are stored as doubles (drawn as GL_DOUBLE): floats are 0.0625 apart around 1e6,
+ * so the vertices of the small Trapezoids far from the origin would collapse.
+ */
+class TrapezoidVertexBuffer
+{
+    private:
+        std::vector<double> fillVertices;
+        std::vector<uint8_t> fillColors;
+        std::vector<double> boundaryVertices;
+
+        void ensureSize(const size_t& index);
+        void setFillVertex(const size_t& vertex, const cg3::Point2d& p, const cg3::Color& color);
+        void setBoundaryVertex(const size_t& vertex, const cg3::Point2d& p);
+    public:
+        static const size_t FILL_VERTICES = 6;
+        static const size_t BOUNDARY_VERTICES = 4;
+
+        TrapezoidVertexBuffer();
+
+        void set(const size_t& index, const DrawableTrapezoid& trapezoid, const double& minX, const double& maxX);
+        void setColor(const size_t& index, const cg3::Color& color);
+        void unset(const size_t& index);
+        void move(const size_t& from, const size_t& to);
+        void resize(const size_t& size);
+
+        size_t size() const;
+
+        const double* getFillVertices() const;
+        const uint8_t* getFillColors() const;
+        size_t getFillVertexCount() const;
+        const double* getBoundaryVertices() const;
+        size_t getBoundaryVertexCount() const;
+
+        void reserve(const size_t& size);
+        void clear();
+};
+
+#endif // TRAPEZOIDVERTEXBUFFER_H
@@ -0,0 +1,184 @@
+#include "trapezoidvertexupdater.h"
+
+#include <algorithm>
+#include <cassert>
+
+/**
+ * @brief TrapezoidVertexUpdater Constructor.
+ * All the Trapezoids of the map are marked, they will be written at the first update.
+ * @param tm, the TrapezoidalMap to keep in sync, it has to notify this object of its changes
+ */
+TrapezoidVertexUpdater::TrapezoidVertexUpdater(const TrapezoidalMap& tm):
+    tm(tm)
+{
+    for(size_t i = 0; i < tm.getTrapezoidalMapSize(); i++)
+        markOutdated(i);
+}
+
+/**
+ * @brief Marks a new or changed Trapezoid, its DrawableTrapezoid will be computed at the next update.
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexUpdater::markOutdated(const size_t& index) {
+    if(index >= outdatedFlags.size())
+        outdatedFlags.resize(index+1, false);
+
+    if(!outdatedFlags[index]) {
+        outdatedFlags[index] = true;
+        outdatedTrapezoids.push_back(index);
+    }
+}
+
+/**
+ * @brief Creates the DrawableTrapezoid of a new or changed Trapezoid and rewrites its range of the vertex buffer,
+ * handling the case in which a "deleted" Trapezoid has been reused.
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexUpdater::updateDrawableTrapezoid(const size_t& index) {
+    assert(index <= drawableTrapezoids.size());
+
+    if(index >= drawableTrapezoids.size())
+        drawableTrapezoids.push_back(DrawableTrapezoid(tm, tm.getTrapezoid(index)));
+    else
+        drawableTrapezoids[index] = DrawableTrapezoid(tm, tm.getTrapezoid(index));
+
+    if(tm.isFreeSlot(index)) {
+        vertexBuffer.resize(std::max(vertexBuffer.size(), index+1));
+        vertexBuffer.unset(index);
+    } else {
+        vertexBuffer.set(index, drawableTrapezoids[index],
+                         tm.getLeftP(tm.getBoundingBox()).x(), tm.getRightP(tm.getBoundingBox()).x());
+    }
+}
+
+/**
+ * @brief Computes the DrawableTrapezoids of the Trapezoids changed since the last update.
+ *
+ * They are processed by increasing index, so that the new ones are appended in order.
+ */
+void TrapezoidVertexUpdater::updateOutdatedTrapezoids() {
+    std::sort(outdatedTrapezoids.begin(), outdatedTrapezoids.end());
+
+    for(const size_t& index : outdatedTrapezoids) {
+        /* Skipping the removed Trapezoids and the duplicates */
+        if(index >= tm.getTrapezoidalMapSize() || !outdatedFlags[index])
+            continue;
+
+        updateDrawableTrapezoid(index);
+        outdatedFlags[index] = false;
+    }
+
+    outdatedTrapezoids.clear();
+}
+
+/**
+ * @brief Checks if the range of a Trapezoid has been written and the Trapezoid has not changed since.
+ * @param index, index of the Trapezoid
+ * @return true if the range of the Trapezoid is up to date
+ */
+bool TrapezoidVertexUpdater::isUpToDate(const size_t& index) const {
+    return index < drawableTrapezoids.size() && !outdatedFlags[index];
+}
+
+/**
+ * @brief Overrides the color of an up to date Trapezoid (e.g. the selected one) until its range is rewritten.
+ * The outdated Trapezoids are skipped.
+ * @param index, index of the Trapezoid
+ * @param color, the color
+ */
+void TrapezoidVertexUpdater::setColor(const size_t& index, const cg3::Color& color) {
+    if(isUpToDate(index))
+        vertexBuffer.setColor(index, color);
+}
+
+/**
+ * @brief Restores the color of the DrawableTrapezoid of an up to date Trapezoid.
+ * The outdated Trapezoids are skipped, they will get their color at the next update.
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexUpdater::restoreColor(const size_t& index) {
+    if(isUpToDate(index))
+        vertexBuffer.setColor(index, drawableTrapezoids[index].getColor());
+}
+
+/**
+ * @brief Returns the vertex arrays of the Trapezoids, as they were at the last update.
+ * @return the vertex buffer
+ */
+const TrapezoidVertexBuffer& TrapezoidVertexUpdater::getVertexBuffer() const {
+    return vertexBuffer;
+}
+
+/**
+ * @brief Marks a new or changed Trapezoid, its DrawableTrapezoid will be computed at the next update.
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexUpdater::trapezoidUpdated(const size_t& index) {
+    markOutdated(index);
+}
+
+/**
+ * @brief Marks a "deleted" Trapezoid, it will be hidden from the vertex buffer at the next update.
+ * @param index, index of the Trapezoid
+ */
+void TrapezoidVertexUpdater::trapezoidFreed(const size_t& index) {
+    markOutdated(index);
+}
+
+/**
+ * @brief Removes the DrawableTrapezoid of a removed free slot, moving the last one in its place.
+ * @param index, index of the removed free slot
+ * @param moved, previous index of the moved Trapezoid, SIZE_MAX if no Trapezoid has been moved
+ */
+void TrapezoidVertexUpdater::trapezoidRemoved(const size_t& index, const size_t& moved) {
+    if(moved != SIZE_MAX) {
+        /* The moved Trapezoid is copied only if it is up to date, otherwise it will be computed in its new place */
+        if(isUpToDate(moved)) {
+            drawableTrapezoids[index] = drawableTrapezoids[moved];
+            vertexBuffer.move(moved, index);
+            outdatedFlags[index] = false;
+        } else {
+            markOutdated(index);
+        }
+    }
+
+    size_t size = tm.getTrapezoidalMapSize();
+    if(drawableTrapezoids.size() > size) {
+        drawableTrapezoids.pop_back();
+        vertexBuffer.resize(size);
+    }
+    outdatedFlags.resize(size);
+}
+
+/**
+ * @brief Reserves space for a given number of DrawableTrapezoids.
+ * @param size, the number of Trapezoids to reserve space for
+ */
+void TrapezoidVertexUpdater::mapReserved(const size_t& size) {
+    drawableTrapezoids.reserve(size);
+    vertexBuffer.reserve(size);
+}
+
+/**
+ * @brief Restores the DrawableTrapezoid of the original Trapezoid after the map has been cleared.
+ */
+void TrapezoidVertexUpdater::mapCleared() {
+    /* Keeps the same color in case the Trapezoidal map was empty */
+    if(drawableTrapezoids.size() == 1 && outdatedTrapezoids.empty()) {
+        cg3::Color bbColor = drawableTrapezoids[0].getColor();
+        drawableTrapezoids.clear();
+
+        drawableTrapezoids.push_back(DrawableTrapezoid(tm, tm.getTrapezoid(0)));
+        drawableTrapezoids[0].setColor(bbColor);
+    } else {
+        drawableTrapezoids.clear();
+        drawableTrapezoids.push_back(DrawableTrapezoid(tm, tm.getTrapezoid(0)));
+    }
+
+    vertexBuffer.clear();
+    vertexBuffer.set(0, drawableTrapezoids[0],
+                     tm.getLeftP(tm.getBoundingBox()).x(), tm.getRightP(tm.getBoundingBox()).x());
+
+    outdatedTrapezoids.clear();
+    outdatedFlags.assign(1, false);
+}
@@ -0,0 +1,46 @@
+#ifndef TRAPEZOIDVERTEXUPDATER_H
+#define TRAPEZOIDVERTEXUPDATER_H
+
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/trapezoidalmap_observer.h"
+#include "drawables/drawabletrapezoid.h"
+#include "drawables/trapezoidvertexbuffer.h"
+
+/**
+ * @brief The TrapezoidVertexUpdater class.
+ * Keeps the DrawableTrapezoids and the TrapezoidVertexBuffer of a TrapezoidalMap in sync with it,
+ * without any OpenGL call: the changed Trapezoids are only marked when they are notified,
+ * their ranges are rewritten by updateOutdatedTrapezoids (e.g. once per frame).
+ */
+class TrapezoidVertexUpdater : public TrapezoidalMapObserver
+{
+    private:
+        const TrapezoidalMap& tm;
+
+        std::vector<DrawableTrapezoid> drawableTrapezoids;
+        TrapezoidVertexBuffer vertexBuffer;
+        std::vector<size_t> outdatedTrapezoids;
+        std::vector<bool> outdatedFlags;
+
+        void markOutdated(const size_t& index);
+        void updateDrawableTrapezoid(const size_t& index);
+    public:
+        TrapezoidVertexUpdater(const TrapezoidalMap& tm);
+        TrapezoidVertexUpdater(const TrapezoidVertexUpdater& other) = delete;
+        TrapezoidVertexUpdater& operator=(const TrapezoidVertexUpdater& other) = delete;
+
+        void updateOutdatedTrapezoids();
+        bool isUpToDate(const size_t& index) const;
+        void setColor(const size_t& index, const cg3::Color& color);
+        void restoreColor(const size_t& index);
+
+        const TrapezoidVertexBuffer& getVertexBuffer() const;
+
+        void trapezoidUpdated(const size_t& index);
+        void trapezoidFreed(const size_t& index);
+        void trapezoidRemoved(const size_t& index, const size_t& moved);
+        void mapReserved(const size_t& size);
+        void mapCleared();
+};
+
+#endif // TRAPEZOIDVERTEXUPDATER_H
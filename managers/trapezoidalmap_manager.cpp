@@ -195,8 +195,7 @@ void TrapezoidalMapManager::addSegmentToTrapezoidalMap(const cg3::Segment2d& seg
     //structures, you could save directly the point (Point2d) in each trapezoid (it is fine).
 
     cg3::Segment2d fixedSegment = Utils::fixSegmentDirection(segment);
-    std::vector<size_t> trapezoids = Algorithms::followSegment(fixedSegment, dag, dtm);
-    Algorithms::updateTrapezoidalMapAndDAG(fixedSegment, trapezoids, dag, dtm);
+    Algorithms::insertSegment(fixedSegment, dag, dtm, insertionBuffers);
     //dtm.updateColors();
 
     //#####################################################################
@@ -524,13 +523,26 @@ void TrapezoidalMapManager::on_loadSegmentsButton_clicked() //Do not write code
         drawableTrapezoidalMapDataset.clear();
 
         //Load input segments in the vector (deleting the previous ones)
-        std::vector<cg3::Segment2d> segments = FileUtils::getSegmentsFromFile(filename.toStdString());
+        std::vector<size_t> malformedLines;
+        std::vector<cg3::Segment2d> segments = FileUtils::getSegmentsFromFile(filename.toStdString(), malformedLines);
+
+        if (!malformedLines.empty()) {
+            for (const size_t& line : malformedLines) {
+                std::cout << "The line " << line << " of the file will be ignored because it cannot be parsed." << std::endl;
+            }
+
+            //Error message cannot parse some lines
+            QMessageBox::warning(this, "Cannot read all segments",
+                "Some lines of the file have been ignored because they cannot be parsed.");
+        }
 
         //Add to the dataset
         bool allSegmentInserted = true;
-        for (const cg3::Segment2d& segment : segments) {
-            bool insertedSegment;
-            drawableTrapezoidalMapDataset.addSegment(segment, insertedSegment);
+        std::vector<bool> insertedSegments;
+        drawableTrapezoidalMapDataset.addSegments(segments, insertedSegments);
+        for (size_t i = 0; i < segments.size(); i++) {
+            const cg3::Segment2d& segment = segments[i];
+            bool insertedSegment = insertedSegments[i];
 
             allSegmentInserted &= insertedSegment;
             if (!insertedSegment) {
@@ -606,7 +618,7 @@ void TrapezoidalMapManager::on_saveSegmentsButton_clicked() //Do not write code
 
     if (!filename.isEmpty()){
         //Save segments in the chosen file
-        FileUtils::saveSegmentsInFile(filename.toStdString(), drawableTrapezoidalMapDataset.getSegments());
+        FileUtils::saveSegmentsInFile(filename.toStdString(), drawableTrapezoidalMapDataset.getSegmentRange());
     }
 }
 
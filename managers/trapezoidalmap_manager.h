@@ -11,6 +11,7 @@
 #include <cg3/geometry/segment2.h>
 
 #include "drawables/drawable_trapezoidalmap_dataset.h"
+#include "drawables/drawabletrapezoidalmap.h"
 
 #include "algorithms/algorithms.h"
 
@@ -61,6 +62,7 @@ private:
 
     DrawableTrapezoidalMap dtm;
     DAG dag;
+    Algorithms::InsertionBuffers insertionBuffers;
 
     //#####################################################################
 
@@ -0,0 +1,211 @@
+#ifndef EXPANSION_H
+#define EXPANSION_H
+
+#include <vector>
+
+/* Exact arithmetic on expansions: sums of non-overlapping doubles, increasing in magnitude,
+ * representing a real number without rounding errors
+ * (J. R. Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates).
+ * The functions working on an Expansion never store zero components, the empty Expansion is 0.
+ * They need every floating point operation to be rounded on its own, without fused multiply-adds */
+
+namespace Utils {
+    typedef std::vector<double> Expansion;
+
+    /* 2^27 + 1, used to split a double in two halves of 26 bits */
+    const double EXPANSION_SPLITTER = 134217729.0;
+
+    /**
+     * @brief Computes a + b exactly as x + y, where x is the rounded sum
+     * (a and b are copied, so that the results can overwrite them)
+     */
+    inline void twoSum(const double a, const double b, double& x, double& y) {
+        x = a + b;
+        double bVirtual = x - a;
+        double aVirtual = x - bVirtual;
+        double bRoundoff = b - bVirtual;
+        double aRoundoff = a - aVirtual;
+        y = aRoundoff + bRoundoff;
+    }
+
+    /**
+     * @brief Splits a in two non-overlapping halves such that a = hi + lo
+     */
+    inline void split(const double& a, double& hi, double& lo) {
+        double c = EXPANSION_SPLITTER * a;
+        double aBig = c - a;
+        hi = c - aBig;
+        lo = a - hi;
+    }
+
+    /**
+     * @brief Computes a * b exactly as x + y, where x is the rounded product
+     * (a and b are copied, so that the results can overwrite them)
+     */
+    inline void twoProduct(const double a, const double b, double& x, double& y) {
+        x = a * b;
+        double aHi, aLo, bHi, bLo;
+        split(a, aHi, aLo);
+        split(b, bHi, bLo);
+        double err1 = x - (aHi * bHi);
+        double err2 = err1 - (aLo * bHi);
+        double err3 = err2 - (aHi * bLo);
+        y = (aLo * bLo) - err3;
+    }
+
+    /**
+     * @brief Adds a double to an expansion stored in an array, keeping its zero components
+     * @param e, the expansion, it has to be able to store one more component
+     * @param length, the number of components of e, it will be increased by one
+     * @param b, the double to add
+     */
+    inline void growExpansion(double* e, size_t& length, const double& b) {
+        double q = b;
+        for(size_t i=0; i<length; i++)
+            twoSum(q, e[i], q, e[i]);
+        e[length++] = q;
+    }
+
+    /**
+     * @brief Computes the orientation determinant of a Point with respect to a Segment exactly,
+     * summing its six products as an expansion
+     * @param e, the expansion, it has to be able to store 12 components
+     * @return the number of components of e
+     */
+    inline size_t orientationExpansion(const double& x1, const double& y1, const double& x2, const double& y2,
+                                       const double& px, const double& py, double* e) {
+        const double factors[6][2] = {{x1, y2}, {-x1, py}, {-y1, x2}, {y1, px}, {x2, py}, {-px, y2}};
+
+        size_t length = 0;
+        for(size_t i=0; i<6; i++) {
+            double x, y;
+            twoProduct(factors[i][0], factors[i][1], x, y);
+            growExpansion(e, length, y);
+            growExpansion(e, length, x);
+        }
+        return length;
+    }
+
+    /**
+     * @brief Computes the orientation determinant of a Point with respect to a Segment exactly
+     * @return the determinant
+     */
+    inline Expansion orientationExpansion(const double& x1, const double& y1, const double& x2, const double& y2,
+                                          const double& px, const double& py) {
+        double e[12];
+        size_t length = orientationExpansion(x1, y1, x2, y2, px, py, e);
+
+        Expansion result;
+        for(size_t i=0; i<length; i++) {
+            if(e[i] != 0)
+                result.push_back(e[i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Adds a double to an expansion
+     * @param e, the expansion, it will contain the sum
+     * @param b, the double to add
+     */
+    inline void growExpansion(Expansion& e, const double& b) {
+        double q = b;
+        size_t length = 0;
+        for(size_t i=0; i<e.size(); i++) {
+            double h;
+            twoSum(q, e[i], q, h);
+            if(h != 0)
+                e[length++] = h;
+        }
+        e.resize(length);
+        if(q != 0)
+            e.push_back(q);
+    }
+
+    /**
+     * @brief Computes the sum of two expansions
+     */
+    inline Expansion sumExpansions(const Expansion& e, const Expansion& f) {
+        Expansion h = e;
+        for(const double& component : f)
+            growExpansion(h, component);
+        return h;
+    }
+
+    /**
+     * @brief Computes the difference of two expansions
+     */
+    inline Expansion subtractExpansions(const Expansion& e, const Expansion& f) {
+        Expansion h = e;
+        for(const double& component : f)
+            growExpansion(h, -component);
+        return h;
+    }
+
+    /**
+     * @brief Computes the product of an expansion and a double
+     */
+    inline Expansion scaleExpansion(const Expansion& e, const double& b) {
+        Expansion h;
+        if(e.empty() || b == 0)
+            return h;
+
+        h.reserve(2 * e.size());
+        double q, hh;
+        twoProduct(e[0], b, q, hh);
+        if(hh != 0)
+            h.push_back(hh);
+        for(size_t i=1; i<e.size(); i++) {
+            double product1, product0, sum;
+            twoProduct(e[i], b, product1, product0);
+            twoSum(q, product0, sum, hh);
+            if(hh != 0)
+                h.push_back(hh);
+            twoSum(product1, sum, q, hh);
+            if(hh != 0)
+                h.push_back(hh);
+        }
+        if(q != 0)
+            h.push_back(q);
+        return h;
+    }
+
+    /**
+     * @brief Computes the product of two expansions
+     */
+    inline Expansion multiplyExpansions(const Expansion& e, const Expansion& f) {
+        Expansion h;
+        for(const double& component : f)
+            h = sumExpansions(h, scaleExpansion(e, component));
+        return h;
+    }
+
+    /**
+     * @brief Computes the sign of an expansion, which is the sign of its largest component
+     * @return -1, 0 or 1
+     */
+    inline int expansionSign(const Expansion& e) {
+        if(e.empty())
+            return 0;
+        return e.back() > 0 ? 1 : -1;
+    }
+
+    /**
+     * @brief Approximates an expansion stored in an array with a double, with a relative error of a few ulps
+     */
+    inline double estimateExpansion(const double* e, const size_t& length) {
+        double sum = 0;
+        for(size_t i=0; i<length; i++)
+            sum += e[i];
+        return sum;
+    }
+
+    /**
+     * @brief Approximates an expansion with a double, with a relative error of a few ulps
+     */
+    inline double estimateExpansion(const Expansion& e) {
+        return estimateExpansion(e.data(), e.size());
+    }
+}
+
+#endif // EXPANSION_H
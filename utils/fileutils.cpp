@@ -1,60 +1,359 @@
 #include "fileutils.h"
 
+#include <algorithm>
 #include <fstream>
 #include <random>
 #include <iomanip>
+#include <sstream>
+#include <cstdio>
+#include <clocale>
+#include <cstdint>
+#include <cmath>
 
 #include "assert.h"
 
 #include "data_structures/trapezoidalmap_dataset.h"
+#include "utils/mappedfile.h"
+
+/* Size of the buffer in which the lines are built before being written */
+#define WRITE_BUFFER_SIZE (1 << 20)
 
 namespace FileUtils {
 
-std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename) {
-    std::vector<cg3::Segment2d> segments;
-	
-	std::ifstream infile;
-    infile.open(filename);
-
-    int n;
-    infile >> n;
-
-    for (int i = 0; i < n; i++) {
-        double x = 0.0;
-        double y = 0.0;
-		
-        infile >> x >> y;
-        cg3::Point2d p1(x,y);
-		
-        infile >> x >> y;
-        cg3::Point2d p2(x,y);
-		
-        segments.push_back(cg3::Segment2d(p1, p2));
-    }
-	
-    return segments;
+namespace {
+
+/* Exact powers of ten, for the fast conversion of the numbers */
+const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool isSpace(const char& c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
 }
 
-std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, const std::vector<cg3::Segment2d>& segments) {
+inline bool isDigit(const char& c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Parses a number in decimal notation, independently of the locale.
+ *
+ * Numbers with at most 19 significant digits whose value can be computed with a single
+ * rounding (mantissa up to 2^53 and power of ten up to 22) are converted directly,
+ * the others through a stream using the classic locale.
+ * @param it, the first character of the number, it will point to the first character after it
+ * @param end, the end of the buffer
+ * @param value, the parsed number
+ * @return true if a number has been parsed
+ */
+bool parseDouble(const char*& it, const char* end, double& value) {
+    const char* begin = it;
+    const char* p = it;
+
+    bool negative = false;
+    if(p != end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    while(p != end && isDigit(*p)) {
+        if(digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if(mantissa != 0)
+                digits++;
+        }
+        else {
+            exponent++;
+        }
+        anyDigit = true;
+        p++;
+    }
+    if(p != end && *p == '.') {
+        p++;
+        while(p != end && isDigit(*p)) {
+            if(digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if(mantissa != 0)
+                    digits++;
+                exponent--;
+            }
+            anyDigit = true;
+            p++;
+        }
+    }
+    if(!anyDigit)
+        return false;
+
+    if(p != end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if(q != end && (*q == '-' || *q == '+')) {
+            negativeExponent = *q == '-';
+            q++;
+        }
+        if(q == end || !isDigit(*q))
+            return false;
+
+        int e = 0;
+        while(q != end && isDigit(*q)) {
+            if(e < 10000)
+                e = e * 10 + (*q - '0');
+            q++;
+        }
+        exponent += negativeExponent ? -e : e;
+        p = q;
+    }
+
+    /* The number has to be followed by a separator */
+    if(p != end && !isSpace(*p) && *p != '\n')
+        return false;
+
+    if(digits < 19 && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+    }
+    else {
+        std::istringstream stream(std::string(begin, p));
+        stream.imbue(std::locale::classic());
+        if(!(stream >> value))
+            return false;
+        negative = false;
+    }
+
+    if(negative)
+        value = -value;
+
+    it = p;
+    return true;
+}
+
+/**
+ * @brief Parses the numbers of a line
+ * @param it, the first character of the line, it will point to the first character of the next line
+ * @param end, the end of the buffer
+ * @param values, array in which the numbers are stored
+ * @param maxValues, the size of the array
+ * @return the number of parsed numbers, or maxValues+1 if the line has more numbers or it is malformed
+ */
+size_t parseLine(const char*& it, const char* end, double* values, const size_t& maxValues) {
+    size_t count = 0;
+    bool malformed = false;
+
+    while(it != end && *it != '\n') {
+        if(isSpace(*it)) {
+            it++;
+        }
+        else if(!malformed && count < maxValues && parseDouble(it, end, values[count])) {
+            count++;
+        }
+        else {
+            malformed = true;
+            it++;
+        }
+    }
+    if(it != end)
+        it++;
+
+    return malformed ? maxValues + 1 : count;
+}
+
+/**
+ * @brief Appends a number with 4 decimal digits to a string using printf,
+ * replacing the decimal point of the current C locale with the classic one
+ */
+void appendDoublePrintf(std::string& buffer, const double& value) {
+    char number[512];
+    int length = std::snprintf(number, sizeof(number), "%.4f", value);
+    if(length < 0)
+        return;
+    if(static_cast<size_t>(length) >= sizeof(number))
+        length = sizeof(number) - 1;
+
+    const char decimalPoint = std::localeconv()->decimal_point[0];
+    if(decimalPoint != '.') {
+        for(int i=0; i<length; i++) {
+            if(number[i] == decimalPoint)
+                number[i] = '.';
+        }
+    }
+
+    buffer.append(number, static_cast<size_t>(length));
+}
+
+/**
+ * @brief Appends a number with 4 decimal digits to a string, exactly as printf("%.4f") does
+ * (rounding half to even on the exact value of the double) but independently of the locale.
+ *
+ * The fractional part f is split as fh + fl, where fh has 26 bits, so that
+ * fh * 10^4 and fl * 10^4 are both exact and the rounding can be decided without errors.
+ */
+void appendDouble(std::string& buffer, const double& value) {
+    if(!(std::fabs(value) < 1e15)) {
+        appendDoublePrintf(buffer, value);
+        return;
+    }
+
+    const double absValue = std::fabs(value);
+    double integerPart = std::floor(absValue);
+    const double fraction = absValue - integerPart;
+
+    const double fractionHi = std::floor(fraction * 67108864.0) / 67108864.0;
+    const double fractionLo = fraction - fractionHi;
+    const double scaledHi = fractionHi * 10000.0;
+    const double scaledLo = fractionLo * 10000.0;
+
+    double decimals = std::floor(scaledHi);
+    double distanceFromHalf = (scaledHi - decimals - 0.5) + scaledLo;
+    if(distanceFromHalf > 0 || (distanceFromHalf == 0 && std::fmod(decimals, 2.0) != 0))
+        decimals += 1;
+
+    uint64_t integerDigits = static_cast<uint64_t>(integerPart);
+    uint64_t decimalDigits = static_cast<uint64_t>(decimals);
+    if(decimalDigits == 10000) {
+        integerDigits++;
+        decimalDigits = 0;
+    }
+
+    char number[32];
+    char* end = number + sizeof(number);
+    char* begin = end;
+
+    for(int i=0; i<4; i++) {
+        *--begin = static_cast<char>('0' + decimalDigits % 10);
+        decimalDigits /= 10;
+    }
+    *--begin = '.';
+    do {
+        *--begin = static_cast<char>('0' + integerDigits % 10);
+        integerDigits /= 10;
+    } while(integerDigits > 0);
+    if(std::signbit(value))
+        *--begin = '-';
+
+    buffer.append(begin, static_cast<size_t>(end - begin));
+}
+
+/**
+ * @brief Writes the Segments in a file, in the format read by getSegmentsFromFile.
+ * The lines are built in a large buffer which is written at once.
+ * @param filename, the name of the file
+ * @param segments, any range of Segments with a size
+ */
+template <class SegmentContainer>
+void writeSegments(const std::string& filename, const SegmentContainer& segments) {
     std::ofstream outfile;
-    outfile.open(filename);
+    outfile.open(filename, std::ios::binary);
 
-    outfile << segments.size() << std::endl;
+    std::string buffer;
+    buffer.reserve(WRITE_BUFFER_SIZE + 256);
+
+    buffer += std::to_string(segments.size());
+    buffer += '\n';
 
     for (const cg3::Segment2d& segment : segments) {
         const cg3::Point2d& p1 = segment.p1();
         const cg3::Point2d& p2 = segment.p2();
 
-        outfile << std::fixed;
-        outfile << std::setprecision(4) << p1.x() << " " << std::setprecision(4) << p1.y() << " ";
-        outfile << std::setprecision(4) << p2.x() << " " << std::setprecision(4) << p2.y();
-        outfile << std::endl;
+        appendDouble(buffer, p1.x());
+        buffer += ' ';
+        appendDouble(buffer, p1.y());
+        buffer += ' ';
+        appendDouble(buffer, p2.x());
+        buffer += ' ';
+        appendDouble(buffer, p2.y());
+        buffer += '\n';
+
+        if(buffer.size() >= WRITE_BUFFER_SIZE) {
+            outfile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
     }
 
+    outfile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
     outfile.close();
+}
+
+}
+
+std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename) {
+    std::vector<size_t> malformedLines;
+    return getSegmentsFromFile(filename, malformedLines);
+}
+
+/**
+ * @brief Reads the Segments from a file.
+ *
+ * The first line contains the number of Segments, each of the next lines contains
+ * the coordinates of a Segment: "x1 y1 x2 y2". Empty lines are ignored.
+ * The file is memory mapped and parsed in place.
+ * @param filename, the name of the file
+ * @param malformedLines, will contain the numbers (starting from 1) of the lines that cannot be parsed
+ * @return the Segments read from the file (at most the number written in the first line)
+ */
+std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename, std::vector<size_t>& malformedLines) {
+    std::vector<cg3::Segment2d> segments;
+    malformedLines.clear();
+
+    MappedFile file;
+    if(!file.open(filename))
+        return segments;
+
+    const char* it = file.getData();
+    const char* end = it + file.getSize();
+    size_t line = 0;
+
+    /* Reading the number of Segments */
+    double header[1];
+    size_t n = SIZE_MAX;
+    while(it != end && n == SIZE_MAX) {
+        line++;
+        size_t count = parseLine(it, end, header, 1);
+        if(count == 1 && header[0] >= 0 && header[0] < 1e18 && header[0] == static_cast<size_t>(header[0]))
+            n = static_cast<size_t>(header[0]);
+        else if(count != 0)
+            malformedLines.push_back(line);
+    }
+
+    /* A line has at least 8 characters, a wrong header cannot make it reserve too much */
+    segments.reserve(std::min(n, file.getSize() / 8));
+
+    double values[4];
+    while(it != end && segments.size() < n) {
+        line++;
+        size_t count = parseLine(it, end, values, 4);
+        if(count == 4)
+            segments.push_back(cg3::Segment2d(cg3::Point2d(values[0], values[1]), cg3::Point2d(values[2], values[3])));
+        else if(count != 0)
+            malformedLines.push_back(line);
+    }
 
     return segments;
 }
 
+/**
+ * @brief Writes the Segments in a file, in the format read by getSegmentsFromFile.
+ * @param filename, the name of the file
+ * @param segments, the Segments
+ * @return the Segments
+ */
+std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, const std::vector<cg3::Segment2d>& segments) {
+    writeSegments(filename, segments);
+
+    return segments;
+}
+
+/**
+ * @brief Writes the Segments of a dataset in a file, without copying them.
+ * @param filename, the name of the file
+ * @param segments, the view over the Segments of the dataset
+ */
+void saveSegmentsInFile(const std::string& filename, const TrapezoidalMapDataset::SegmentRange& segments) {
+    writeSegments(filename, segments);
+}
+
 
 }
@@ -5,11 +5,15 @@
 #include <cg3/geometry/point2.h>
 #include <cg3/geometry/segment2.h>
 
+#include "data_structures/trapezoidalmap_dataset.h"
+
 namespace FileUtils {
 
 std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename);
+std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename, std::vector<size_t>& malformedLines);
 
 std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, const std::vector<cg3::Segment2d>& segments);
+void saveSegmentsInFile(const std::string& filename, const TrapezoidalMapDataset::SegmentRange& segments);
 
 }
 
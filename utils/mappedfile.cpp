@@ -0,0 +1,118 @@
+#include "mappedfile.h"
+
+#include <fstream>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief MappedFile Constructor, no file is opened
+ */
+MappedFile::MappedFile() {
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    opened = false;
+}
+
+/**
+ * @brief MappedFile Destructor, releases the mapping
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * @brief Maps a file in memory, closing the previous one
+ * @param filename, the name of the file
+ * @return true if the file has been opened
+ */
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef __unix__
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat info;
+    if(fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if(address != MAP_FAILED) {
+            data = static_cast<const char*>(address);
+            size = static_cast<size_t>(info.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+
+    if(mapped) {
+        opened = true;
+        return true;
+    }
+#endif
+
+    /* Reading the whole file when it cannot be mapped (or it is empty) */
+    std::ifstream infile(filename, std::ios::binary | std::ios::ate);
+    if(!infile)
+        return false;
+
+    std::streamoff fileSize = infile.tellg();
+    infile.seekg(0);
+    buffer.resize(static_cast<size_t>(fileSize));
+    if(fileSize > 0 && !infile.read(buffer.data(), fileSize)) {
+        buffer.clear();
+        return false;
+    }
+
+    data = buffer.data();
+    size = buffer.size();
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief Releases the mapping of the file
+ */
+void MappedFile::close() {
+#ifdef __unix__
+    if(mapped)
+        munmap(const_cast<char*>(data), size);
+#endif
+
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    opened = false;
+
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+/**
+ * @brief Tells if a file is currently opened
+ * @return true if a file is opened
+ */
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+/**
+ * @brief Getter for the content of the file
+ * @return a pointer to the first byte of the file
+ */
+const char* MappedFile::getData() const {
+    return data;
+}
+
+/**
+ * @brief Getter for the size of the file
+ * @return the size in bytes
+ */
+size_t MappedFile::getSize() const {
+    return size;
+}
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief The MappedFile class.
+ * A read-only file mapped in memory (through mmap on unix systems,
+ * read in a buffer on the other ones).
+ * The mapping is released when the MappedFile is closed or destroyed.
+ */
+class MappedFile {
+    private:
+        const char* data;
+        size_t size;
+
+        /* Used when the file cannot be mapped */
+        std::vector<char> buffer;
+        bool mapped;
+        bool opened;
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& filename);
+        void close();
+
+        bool isOpen() const;
+        const char* getData() const;
+        size_t getSize() const;
+};
+
+#endif // MAPPEDFILE_H
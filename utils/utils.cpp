@@ -1,6 +1,46 @@
 #include "utils.h"
 
+#include "expansion.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef ORIENTATION_STATISTICS
+#include <atomic>
+#endif
+
 namespace Utils {
+    namespace {
+        /* Machine epsilon (half ulp of 1) and the error bound of the fast orientation test
+         * (J. R. Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates) */
+        const double epsilon = std::numeric_limits<double>::epsilon() / 2;
+        const double orientationErrorBound = (3.0 + 16.0 * epsilon) * epsilon;
+
+#ifdef ORIENTATION_STATISTICS
+        std::atomic<unsigned long long> fastOrientationTests(0);
+        std::atomic<unsigned long long> exactOrientationTests(0);
+#endif
+
+        /**
+         * @brief Computes the sign of the orientation determinant exactly,
+         * summing its six products as an expansion
+         * @return a value with the same sign of the determinant
+         */
+        double exactOrientation(const double& x1, const double& y1, const double& x2, const double& y2,
+                                const double& px, const double& py) {
+            double e[12];
+            size_t length = orientationExpansion(x1, y1, x2, y2, px, py, e);
+
+            /* The sign of an expansion is the sign of its largest non-zero component */
+            for(size_t i=length; i>0; i--) {
+                if(e[i-1] != 0)
+                    return e[i-1];
+            }
+            return 0;
+        }
+    }
+
+
     /**
      * @brief Calculates if a given Point is on the left of a given Segment
      * @param s, the Segment
@@ -8,14 +48,71 @@ namespace Utils {
      * @return true if p is on the left of s, false otherwise
     */
     bool isPointOnTheLeft(const cg3::Segment2d& s, const cg3::Point2d& p) {
-        float det = s.p1().x() * (s.p2().y() - p.y()) -
-                    s.p1().y() * (s.p2().x() - p.x()) +
-                    s.p2().x() * p.y() - p.x() * s.p2().y();
-        if(det >= 0)
-            return true;
-        else
-            return false;
+        return isPointOnTheLeft(s.p1().x(), s.p1().y(), s.p2().x(), s.p2().y(), p.x(), p.y());
+    }
+
+    /**
+     * @brief Calculates if a given Point is on the left of a given Segment, both given through their coordinates
+     * @param x1, y1, the first endpoint of the Segment
+     * @param x2, y2, the second endpoint of the Segment
+     * @param px, py, the Point
+     * @return true if the Point is on the left of the Segment, false otherwise
+    */
+    bool isPointOnTheLeft(const double& x1, const double& y1, const double& x2, const double& y2,
+                          const double& px, const double& py) {
+        return orientation(x1, y1, x2, y2, px, py) >= 0;
+    }
+
+    /**
+     * @brief Computes the orientation of a Point with respect to a Segment, both given through their coordinates.
+     *
+     * The determinant is computed in double precision and it is trusted when it is larger
+     * than its error bound, otherwise it is computed again exactly.
+     * @param x1, y1, the first endpoint of the Segment
+     * @param x2, y2, the second endpoint of the Segment
+     * @param px, py, the Point
+     * @return a positive value if the Point is on the left of the Segment, a negative value if it is on the right,
+     * zero if the three points are collinear
+    */
+    double orientation(const double& x1, const double& y1, const double& x2, const double& y2,
+                       const double& px, const double& py) {
+        double detLeft = (x1 - px) * (y2 - py);
+        double detRight = (y1 - py) * (x2 - px);
+        double det = detLeft - detRight;
+
+        double errorBound = orientationErrorBound * (std::fabs(detLeft) + std::fabs(detRight));
+        if(det > errorBound || -det > errorBound) {
+#ifdef ORIENTATION_STATISTICS
+            fastOrientationTests.fetch_add(1, std::memory_order_relaxed);
+#endif
+            return det;
+        }
+
+#ifdef ORIENTATION_STATISTICS
+        exactOrientationTests.fetch_add(1, std::memory_order_relaxed);
+#endif
+        return exactOrientation(x1, y1, x2, y2, px, py);
+    }
+
+#ifdef ORIENTATION_STATISTICS
+    /**
+     * @brief Returns how many orientation tests have been solved by the fast path and by the exact computation
+     * @param fastTests, the number of tests solved in double precision
+     * @param exactTests, the number of tests that needed the exact computation
+     */
+    void getOrientationStatistics(unsigned long long& fastTests, unsigned long long& exactTests) {
+        fastTests = fastOrientationTests.load();
+        exactTests = exactOrientationTests.load();
+    }
+
+    /**
+     * @brief Resets the counters of the orientation tests
+     */
+    void resetOrientationStatistics() {
+        fastOrientationTests.store(0);
+        exactOrientationTests.store(0);
     }
+#endif
 
     /**
      * @brief Fixes the direction of a Segment making it so that it goes from Left to Right.
@@ -4,9 +4,57 @@
 #include <cg3/geometry/segment2.h>
 #include <cg3/geometry/point2.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/* Define ORIENTATION_STATISTICS to count how many orientation tests
+   are solved by the fast path and how many need the exact computation */
+
 namespace Utils {
     bool isPointOnTheLeft(const cg3::Segment2d& s, const cg3::Point2d& p);
+    bool isPointOnTheLeft(const double& x1, const double& y1, const double& x2, const double& y2,
+                          const double& px, const double& py);
+    double orientation(const double& x1, const double& y1, const double& x2, const double& y2,
+                       const double& px, const double& py);
+#ifdef ORIENTATION_STATISTICS
+    void getOrientationStatistics(unsigned long long& fastTests, unsigned long long& exactTests);
+    void resetOrientationStatistics();
+#endif
     cg3::Segment2d fixSegmentDirection(const cg3::Segment2d& s);
+
+    /**
+     * @brief Calls a function on contiguous chunks of the range [0, size), each one on a different thread.
+     * @param size, the size of the range
+     * @param threads, the number of threads to use (0 to use all the available cores)
+     * @param minChunkSize, the minimum size of a chunk, smaller ranges are processed on the calling thread
+     * @param function, the function, called as function(begin, end) for each chunk
+     */
+    template <typename Function>
+    void parallelFor(const size_t& size, const unsigned int& threads, const size_t& minChunkSize, const Function& function) {
+        size_t nThreads = threads;
+        if(nThreads == 0)
+            nThreads = std::thread::hardware_concurrency();
+        nThreads = std::min(nThreads, size / std::max(minChunkSize, size_t(1)));
+
+        if(nThreads <= 1) {
+            function(size_t(0), size);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(nThreads);
+
+        size_t chunkSize = (size + nThreads - 1) / nThreads;
+        for(size_t t=0; t<nThreads; t++) {
+            size_t begin = t * chunkSize;
+            size_t end = std::min(begin + chunkSize, size);
+            workers.push_back(std::thread(function, begin, end));
+        }
+
+        for(std::thread& worker : workers)
+            worker.join();
+    }
 }
 
 #endif // UTILS_H